@@ -0,0 +1,257 @@
+// Headless benchmarks for the host build. Each scenario plays a level for a
+// fixed number of ticks twice: once stepping only the sim, and once stepping
+// and drawing every tick into a software renderer, the same frame path the
+// game uses. Input comes from a recorded replay or, for generated levels,
+// from a paddle that follows the first ball.
+//
+// usage: breakout_bench [--ticks N] [--json FILE] [--replay FILE]...
+// Compare two JSON reports with bench/compare.py.
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "alloc_tracker.h"
+#include "arena.h"
+#include "render_batch.h"
+#include "replay.h"
+#include "scene.h"
+#include "sim.h"
+
+namespace
+{
+	const size_t	frameArenaSize	= 16 << 20;
+	const uint32_t	warmupTicks		= 2;	// Let scratch buffers reach their working size
+
+	struct Scenario
+	{
+		char	name[64];
+		Replay	start;				// Starting state, and the inputs when useReplay is set
+		bool	useReplay = false;
+	};
+
+	struct ScenarioResult
+	{
+		const char*	name;
+		uint32_t	blocks;
+		uint32_t	ticks;
+		double		simNsPerTick;
+		double		frameNsPerTick;
+		double		drawCallsPerFrame;
+		double		allocationsPerFrame;
+		double		peakHeapKb;
+	};
+
+	int16_t FollowBall(const WorldState& world)
+	{
+		const float follow = world.balls.x[0] - (world.paddle.x + world.paddle.w / 2);
+		return int16_t(std::max(-32768.0f, std::min(follow * 2000.0f, 32767.0f)));
+	}
+
+	// Plays up to ticks ticks of the scenario, calling frame after each one.
+	// Generated levels restart when a game ends; a replay stops with its game.
+	template<typename TY_FN>
+	uint32_t Play(BreakoutSim& sim, const Scenario& scenario, const uint32_t ticks, Uint64& stepTicks, TY_FN frame)
+	{
+		scenario.start.Start(sim);
+
+		ReplayPlayer player(scenario.start);
+
+		for (uint32_t tick = 0; tick < ticks; tick++)
+		{
+			SimInput input;
+			if (scenario.useReplay)
+			{
+				if (!player.Next(input))
+					return tick;
+			}
+			else
+				input.paddleAxis = FollowBall(sim.world);
+
+			const Uint64 stepStart = SDL_GetPerformanceCounter();
+			const SimStatus status = sim.Step(input, scenario.start.tickDt);
+			stepTicks += SDL_GetPerformanceCounter() - stepStart;
+
+			frame(tick);
+
+			if (status != SimStatus::Running)
+			{
+				if (scenario.useReplay)
+					return tick + 1;
+
+				scenario.start.Start(sim);
+			}
+		}
+
+		return ticks;
+	}
+
+	ScenarioResult RunScenario(const Scenario& scenario, const uint32_t ticks, SDL_Renderer* renderer, FrameArena& arena)
+	{
+		const double nsPerCounterTick = 1e9 / double(SDL_GetPerformanceFrequency());
+
+		ScenarioResult result	= {};
+		result.name				= scenario.name;
+
+		// Peak heap counts only what this scenario allocates on top of what
+		// was live before it, so scenarios do not inherit each other's peak.
+		const uint64_t heapBefore = AllocatedBytes();
+		ResetPeakAllocatedBytes();
+
+		BreakoutSim sim;
+
+		Uint64 simTicks = 0;
+		result.ticks	= Play(sim, scenario, ticks, simTicks, [](uint32_t) {});
+		result.blocks	= sim.world.blocks.count;
+
+		// The frame pass times step plus draw, and counts submits and heap
+		// allocations after the warmup ticks.
+		Uint64 frameTicks		= 0;
+		Uint64 stepTicks		= 0;
+		Uint64 submits			= 0;
+		Uint64 allocations		= 0;
+
+		Play(sim, scenario, ticks, stepTicks, [&](const uint32_t tick)
+		{
+			arena.Reset();
+
+			const uint64_t submitsBefore		= GeometrySubmitCount();
+			const uint64_t allocationsBefore	= AllocationCount();
+			const Uint64	drawStart			= SDL_GetPerformanceCounter();
+
+			DrawWorld(renderer, sim.world, 1.0f, scenario.start.tickDt, arena);
+			SDL_RenderPresent(renderer);
+
+			frameTicks += SDL_GetPerformanceCounter() - drawStart;
+
+			if (tick >= warmupTicks)
+			{
+				submits		+= GeometrySubmitCount() - submitsBefore;
+				allocations	+= AllocationCount() - allocationsBefore;
+			}
+		});
+
+		const double frames			= double(std::max(result.ticks, 1u));
+		const double countedFrames	= double(std::max(result.ticks, warmupTicks + 1) - warmupTicks);
+
+		result.simNsPerTick			= simTicks * nsPerCounterTick / frames;
+		result.frameNsPerTick		= (frameTicks + stepTicks) * nsPerCounterTick / frames;
+		result.drawCallsPerFrame	= submits / countedFrames;
+		result.allocationsPerFrame	= allocations / countedFrames;
+		result.peakHeapKb			= double(PeakAllocatedBytes() - heapBefore) / 1024.0;
+
+		return result;
+	}
+
+	Scenario GeneratedScenario(const char* name, const LevelPattern pattern, const uint32_t blockCount, const float density, const uint32_t ballCount)
+	{
+		Scenario scenario;
+		snprintf(scenario.name, sizeof(scenario.name), "%s", name);
+
+		scenario.start.levelKind			= ReplayLevelGenerated;
+		scenario.start.levelGen.pattern		= pattern;
+		scenario.start.levelGen.blockCount	= blockCount;
+		scenario.start.levelGen.density		= density;
+		scenario.start.ballCount			= ballCount;
+
+		return scenario;
+	}
+
+	bool WriteJson(const char* path, const std::vector<ScenarioResult>& results, const uint32_t ticks)
+	{
+		FILE* file = fopen(path, "w");
+		if (!file)
+		{
+			printf("failed to open %s\n", path);
+			return false;
+		}
+
+		fprintf(file, "{\n\t\"ticks\": %u,\n\t\"scenarios\": [\n", ticks);
+
+		for (size_t I = 0; I < results.size(); I++)
+		{
+			const ScenarioResult& result = results[I];
+
+			fprintf(file,
+				"\t\t{ \"name\": \"%s\", \"blocks\": %u, \"ticks\": %u, \"sim_ns_per_tick\": %.1f, \"frame_ns_per_tick\": %.1f, "
+				"\"draw_calls_per_frame\": %.2f, \"allocations_per_frame\": %.2f, \"peak_heap_kb\": %.1f }%s\n",
+				result.name, result.blocks, result.ticks, result.simNsPerTick, result.frameNsPerTick,
+				result.drawCallsPerFrame, result.allocationsPerFrame, result.peakHeapKb,
+				I + 1 < results.size() ? "," : "");
+		}
+
+		fprintf(file, "\t]\n}\n");
+		fclose(file);
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t	ticks		= 2000;
+	const char*	jsonPath	= nullptr;
+
+	std::vector<Scenario> scenarios;
+	scenarios.push_back(GeneratedScenario("bricks-1k",		PatternBricks,	1000,	1.0f, 1));
+	scenarios.push_back(GeneratedScenario("bricks-10k",		PatternBricks,	10000,	1.0f, 1));
+	scenarios.push_back(GeneratedScenario("bricks-100k",	PatternBricks,	100000,	1.0f, 1));
+	scenarios.push_back(GeneratedScenario("noise-10k",		PatternNoise,	10000,	0.5f, 1));
+	scenarios.push_back(GeneratedScenario("balls-1k",		PatternBricks,	1000,	1.0f, 1024));
+
+	for (int I = 1; I + 1 < argc; I += 2)
+	{
+		if (strcmp(argv[I], "--ticks") == 0)
+			ticks = uint32_t(std::max(1, atoi(argv[I + 1])));
+		else if (strcmp(argv[I], "--json") == 0)
+			jsonPath = argv[I + 1];
+		else if (strcmp(argv[I], "--replay") == 0)
+		{
+			Scenario scenario;
+			snprintf(scenario.name, sizeof(scenario.name), "replay:%s", argv[I + 1]);
+			scenario.useReplay = true;
+
+			if (!scenario.start.Load(argv[I + 1]))
+				return 1;
+
+			scenarios.push_back(scenario);
+		}
+	}
+
+	SDL_Surface*	target		= SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA8888);
+	SDL_Renderer*	renderer	= target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+
+	if (!renderer)
+	{
+		printf("failed to create a software renderer: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	FrameArena arena(frameArenaSize);
+
+	std::vector<ScenarioResult> results;
+
+	printf("%-24s %8s %8s %14s %14s %10s %10s %10s\n", "scenario", "blocks", "ticks", "sim ns/tick", "frame ns/tick", "draws", "allocs", "heap kb");
+
+	for (const Scenario& scenario : scenarios)
+	{
+		const ScenarioResult result = RunScenario(scenario, ticks, renderer, arena);
+		results.push_back(result);
+
+		printf("%-24s %8u %8u %14.1f %14.1f %10.2f %10.2f %10.1f\n",
+			result.name, result.blocks, result.ticks, result.simNsPerTick, result.frameNsPerTick,
+			result.drawCallsPerFrame, result.allocationsPerFrame, result.peakHeapKb);
+	}
+
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+
+	if (jsonPath && !WriteJson(jsonPath, results, ticks))
+		return 1;
+
+	return 0;
+}
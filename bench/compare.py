@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Compares two breakout_bench JSON reports and flags regressions.
+
+usage: compare.py BASELINE.json CANDIDATE.json [--threshold PERCENT]
+
+Every metric is lower-is-better. A metric regresses when the candidate is
+more than PERCENT (default 5) worse than the baseline; the exit status is 1
+if anything regressed, so the script can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+METRICS = [
+    "sim_ns_per_tick",
+    "frame_ns_per_tick",
+    "draw_calls_per_frame",
+    "allocations_per_frame",
+    "peak_heap_kb",
+]
+
+
+def load(path):
+    with open(path) as report:
+        return {scenario["name"]: scenario for scenario in json.load(report)["scenarios"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag regressions between two breakout_bench reports.")
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=5.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+
+    regressions = 0
+
+    print(f"{'scenario':<24} {'metric':<24} {'baseline':>14} {'candidate':>14} {'change':>9}")
+
+    for name, base in baseline.items():
+        if name not in candidate:
+            print(f"{name:<24} missing from candidate")
+            continue
+
+        for metric in METRICS:
+            # Reports from older builds may lack a metric.
+            if metric not in base or metric not in candidate[name]:
+                continue
+
+            old = base[metric]
+            new = candidate[name][metric]
+
+            if old == 0:
+                change = 0.0 if new == 0 else float("inf")
+            else:
+                change = (new - old) / old * 100.0
+
+            regressed = change > args.threshold
+            regressions += regressed
+
+            print(f"{name:<24} {metric:<24} {old:>14.2f} {new:>14.2f} {change:>+8.1f}%{'  REGRESSION' if regressed else ''}")
+
+    print(f"{regressions} regression(s) past {args.threshold:.1f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
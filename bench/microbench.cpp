@@ -0,0 +1,228 @@
+// Microbenchmarks for the hot functions behind the game loop, each timed in
+// isolation over randomized inputs so an optimization can be measured before
+// it lands. Run from the build directory, where font.ttf is copied.
+//
+// usage: breakout_microbench [--filter SUBSTRING]
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "block_field.h"
+#include "font_atlas.h"
+#include "geometry.h"
+#include "level_gen.h"
+#include "render_batch.h"
+#include "sim.h"
+#include "text.h"
+
+namespace
+{
+	const double minSeconds = 0.2;		// Each benchmark runs at least this long
+
+	const char* filter = nullptr;
+
+	// Results feed into this so the compiler cannot drop the work.
+	volatile uint64_t sink = 0;
+
+	uint32_t NextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return state;
+	}
+
+	float RandomRange(uint32_t& state, const float min, const float max)
+	{
+		return min + (max - min) * float(NextRandom(state) >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Calls fn(I) for I = 0, 1, 2... in batches that double until the run
+	// takes minSeconds, then prints the cost of one call.
+	template<typename TY_FN>
+	void Run(const char* name, TY_FN fn)
+	{
+		if (filter && !strstr(name, filter))
+			return;
+
+		const double frequency = double(SDL_GetPerformanceFrequency());
+
+		uint64_t calls		= 0;
+		double	 seconds	= 0.0;
+
+		for (uint64_t batch = 1; seconds < minSeconds; batch *= 2)
+		{
+			const Uint64 start = SDL_GetPerformanceCounter();
+
+			for (uint64_t I = 0; I < batch; I++)
+				fn(uint32_t(calls + I));
+
+			seconds	+= double(SDL_GetPerformanceCounter() - start) / frequency;
+			calls	+= batch;
+		}
+
+		printf("%-36s %14.1f ns/call %12.3f M calls/s\n", name, seconds * 1e9 / calls, calls / seconds / 1e6);
+	}
+
+	bool LoadFile(const char* path, std::vector<uint8_t>& data)
+	{
+		FILE* file = fopen(path, "rb");
+		if (!file)
+			return false;
+
+		fseek(file, 0, SEEK_END);
+		data.resize(size_t(ftell(file)));
+		fseek(file, 0, SEEK_SET);
+
+		const bool read = fread(data.data(), data.size(), 1, file) == 1;
+		fclose(file);
+
+		return read;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	for (int I = 1; I + 1 < argc; I += 2)
+	{
+		if (strcmp(argv[I], "--filter") == 0)
+			filter = argv[I + 1];
+	}
+
+	// Random shapes over the play area, sized like blocks and balls. The
+	// count is a power of two so inputs cycle with a mask.
+	const uint32_t inputCount = 4096;
+
+	std::vector<Rect>	rects(inputCount);
+	std::vector<Circle>	circles(inputCount);
+	std::vector<float>	moves(inputCount * 2);
+
+	uint32_t random = 0x12345678;
+
+	for (uint32_t I = 0; I < inputCount; I++)
+	{
+		rects[I]			= Rect{ RandomRange(random, 0, SCREEN_WIDTH), RandomRange(random, 0, SCREEN_HEIGHT), RandomRange(random, 10, 100), RandomRange(random, 10, 60) };
+		circles[I]			= Circle{ RandomRange(random, 0, SCREEN_WIDTH), RandomRange(random, 0, SCREEN_HEIGHT), RandomRange(random, 5, 50) };
+		moves[I * 2 + 0]	= RandomRange(random, -100, 100);
+		moves[I * 2 + 1]	= RandomRange(random, -100, 100);
+	}
+
+	const uint32_t mask = inputCount - 1;
+
+	Run("Distance", [&](const uint32_t I)
+	{
+		const Circle& a = circles[I & mask];
+		const Circle& b = circles[(I + 1) & mask];
+
+		sink += uint64_t(Distance(a.x, a.y, b.x, b.y));
+	});
+
+	Run("RectangleCircleIntersection", [&](const uint32_t I)
+	{
+		sink += RectangleCircleIntersection(rects[I & mask], circles[(I * 7) & mask]);
+	});
+
+	Run("RectangleCircleContact", [&](const uint32_t I)
+	{
+		BlockHit hit;
+		sink += RectangleCircleContact(rects[I & mask], circles[(I * 7) & mask], hit);
+	});
+
+	Run("SweptCircleRect", [&](const uint32_t I)
+	{
+		const uint32_t J = (I * 7) & mask;
+
+		float t, nx, ny;
+		sink += SweptCircleRect(rects[I & mask], circles[J], moves[J * 2], moves[J * 2 + 1], t, nx, ny);
+	});
+
+	// Overlap kernels over a whole 10k block field, one ball per call.
+	{
+		LevelGenParams params;
+		params.blockCount = 10000;
+
+		std::vector<LevelBlock> levelBlocks;
+		GenerateLevel(params, levelBlocks);
+
+		BlockField blocks;
+		blocks.Assign(levelBlocks);
+
+		std::vector<uint32_t> hits(blocks.count);
+
+		auto overlaps = [&](const char* name, uint32_t (*kernel)(const BlockField&, uint32_t, uint32_t, const Circle&, uint32_t*))
+		{
+			Run(name, [&](const uint32_t I)
+			{
+				sink += kernel(blocks, 0, blocks.count, circles[I & mask], hits.data());
+			});
+		};
+
+		overlaps("CircleBlockOverlapsScalar 10k", CircleBlockOverlapsScalar);
+#if defined(__SSE2__)
+		overlaps("CircleBlockOverlapsSSE 10k", CircleBlockOverlapsSSE);
+#endif
+#if defined(__AVX2__)
+		overlaps("CircleBlockOverlapsAVX2 10k", CircleBlockOverlapsAVX2);
+#endif
+	}
+
+	// Circle vertex generation as the scene draws balls, without submitting.
+	{
+		GeometryBatch batch;
+		batch.Reserve(1024 * 8);
+
+		Run("GeometryBatch::AddCircle 16", [&](const uint32_t I)
+		{
+			if ((I & 1023) == 0)
+				batch.Clear();
+
+			const Circle& circle = circles[I & mask];
+			batch.AddCircle(circle.x, circle.y, circle.r, 16, SDL_Color{ 0x65, 0x64, 0x7c, 255 });
+		});
+	}
+
+	std::vector<uint8_t> ttf;
+	if (!LoadFile("font.ttf", ttf))
+	{
+		printf("font.ttf not found, skipping text benchmarks\n");
+		return 0;
+	}
+
+	FontAtlas atlas;
+
+	Run("BuildFontAtlas", [&](const uint32_t)
+	{
+		BuildFontAtlas(ttf.data(), atlas);
+		sink += atlas.width;
+	});
+
+	// DrawButton's layout: measure the label, then emit its glyph quads.
+	{
+		FontAsset font		= {};
+		font.atlasWidth		= atlas.width;
+		font.atlasHeight	= atlas.height;
+		font.pixelHeight	= atlas.pixelHeight;
+		font.ascent			= atlas.ascent;
+		memcpy(font.glyphs, atlas.glyphs, sizeof(font.glyphs));
+
+		GeometryBatch batch;
+		batch.Reserve(64);
+
+		Run("Button text layout", [&](const uint32_t)
+		{
+			const float textWidth	= std::max(MeasureText(font, "Player Wins"), 1.0f);
+			const float scale		= std::min(192 * 0.9f / textWidth, 100 * 0.8f / font.pixelHeight);
+
+			AddText(batch, font, (192 - textWidth * scale) / 2.0f, (100 - font.pixelHeight * scale) / 2.0f, scale, "Player Wins", SDL_Color{ 0xFF, 0xFF, 0xFF, 0xFF });
+			sink += batch.VertexCount();
+			batch.Clear();
+		});
+	}
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if BREAKOUT_COUNT_ALLOCATIONS
+
+namespace
+{
+	// Each block starts with a header holding its size, so frees can be
+	// counted too. It keeps the default new alignment.
+	const size_t headerSize = alignof(std::max_align_t);
+
+	thread_local uint64_t allocationCount = 0;
+
+	// Process-wide, since a block may be freed on another thread.
+	std::atomic<uint64_t> allocatedBytes{ 0 };
+	std::atomic<uint64_t> peakAllocatedBytes{ 0 };
+
+	void* CountedAllocate(const size_t size)
+	{
+		allocationCount++;
+
+		uint8_t* block = static_cast<uint8_t*>(std::malloc(headerSize + size));
+		if (!block)
+			throw std::bad_alloc();
+
+		*reinterpret_cast<size_t*>(block) = size;
+
+		const uint64_t bytes	= allocatedBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		uint64_t peak			= peakAllocatedBytes.load(std::memory_order_relaxed);
+
+		while (bytes > peak && !peakAllocatedBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {}
+
+		return block + headerSize;
+	}
+
+	void CountedFree(void* ptr)
+	{
+		if (!ptr)
+			return;
+
+		uint8_t* block = static_cast<uint8_t*>(ptr) - headerSize;
+
+		allocatedBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+		std::free(block);
+	}
+}
+
+void* operator new(size_t size)		{ return CountedAllocate(size); }
+void* operator new[](size_t size)	{ return CountedAllocate(size); }
+
+void operator delete(void* ptr) noexcept			{ CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept			{ CountedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept	{ CountedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept	{ CountedFree(ptr); }
+
+uint64_t AllocationCount()
+{
+	return allocationCount;
+}
+
+uint64_t AllocatedBytes()
+{
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t PeakAllocatedBytes()
+{
+	return peakAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+void ResetPeakAllocatedBytes()
+{
+	peakAllocatedBytes.store(allocatedBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#else
+
+uint64_t AllocationCount()
+{
+	return 0;
+}
+
+uint64_t AllocatedBytes()
+{
+	return 0;
+}
+
+uint64_t PeakAllocatedBytes()
+{
+	return 0;
+}
+
+void ResetPeakAllocatedBytes()
+{
+}
+
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Debug builds replace the global operator new to count heap allocations
+// and the bytes they hold, so steady_state_test can check the game loop
+// reaches a state that never touches the heap and the benchmarks can report
+// each scenario's peak heap. Release builds keep the standard allocator and
+// always report 0, unless BREAKOUT_COUNT_ALLOCATIONS is defined to 1.
+
+#if !defined(BREAKOUT_COUNT_ALLOCATIONS)
+#if !defined(NDEBUG)
+#define BREAKOUT_COUNT_ALLOCATIONS 1
+#else
+#define BREAKOUT_COUNT_ALLOCATIONS 0
+#endif
+#endif
+
+// operator new calls made so far on the calling thread.
+uint64_t AllocationCount();
+
+// Bytes allocated with operator new and not yet freed, on any thread, and
+// the most there have been since the last ResetPeakAllocatedBytes.
+uint64_t AllocatedBytes();
+uint64_t PeakAllocatedBytes();
+void	 ResetPeakAllocatedBytes();
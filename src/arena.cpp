@@ -0,0 +1,33 @@
+#include "arena.h"
+
+#include <algorithm>
+
+FrameArena::FrameArena(const size_t capacity_)
+	: buffer{ new uint8_t[capacity_] }, capacity{ capacity_ }
+{
+}
+
+FrameArena::~FrameArena()
+{
+	delete[] buffer;
+}
+
+void* FrameArena::Allocate(const size_t size, const size_t alignment)
+{
+	const uintptr_t base	= uintptr_t(buffer);
+	const uintptr_t aligned	= (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+	const size_t	end		= size_t(aligned - base) + size;
+
+	if (end > capacity)
+		return nullptr;
+
+	offset		= end;
+	highWater	= std::max(highWater, offset);
+
+	return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::Reset()
+{
+	offset = 0;
+}
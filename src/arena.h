@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bump-pointer allocator for data that only lives for one frame. The buffer
+// is allocated once up front, and Reset at the top of each frame frees
+// everything handed out since the last reset.
+class FrameArena
+{
+public:
+	explicit FrameArena(const size_t capacity);
+	~FrameArena();
+
+	FrameArena(const FrameArena&)				= delete;
+	FrameArena& operator = (const FrameArena&)	= delete;
+
+	// Returns nullptr when the arena is full.
+	void*	Allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+	void	Reset();
+
+	bool	Owns(const void* ptr) const { return ptr >= buffer && ptr < buffer + capacity; }
+
+	size_t	Used() const		{ return offset; }
+	size_t	HighWater() const	{ return highWater; }
+
+private:
+	uint8_t*	buffer;
+	size_t		capacity;
+	size_t		offset		= 0;
+	size_t		highWater	= 0;
+};
+
+// Standard allocator over a FrameArena, for containers that are rebuilt
+// every frame. Falls back to the heap when there is no arena or it is full;
+// freeing arena memory is a no-op.
+template<typename TY>
+struct ArenaAllocator
+{
+	using value_type = TY;
+
+	FrameArena* arena = nullptr;
+
+	ArenaAllocator() = default;
+	ArenaAllocator(FrameArena* arena_) : arena{ arena_ } {}
+
+	template<typename TY_OTHER>
+	ArenaAllocator(const ArenaAllocator<TY_OTHER>& other) : arena{ other.arena } {}
+
+	TY* allocate(const size_t count)
+	{
+		if (arena)
+		{
+			if (void* ptr = arena->Allocate(count * sizeof(TY), alignof(TY)))
+				return static_cast<TY*>(ptr);
+		}
+
+		return static_cast<TY*>(::operator new(count * sizeof(TY)));
+	}
+
+	void deallocate(TY* ptr, const size_t)
+	{
+		if (!arena || !arena->Owns(ptr))
+			::operator delete(ptr);
+	}
+
+	template<typename TY_OTHER>
+	bool operator == (const ArenaAllocator<TY_OTHER>& other) const { return arena == other.arena; }
+
+	template<typename TY_OTHER>
+	bool operator != (const ArenaAllocator<TY_OTHER>& other) const { return arena != other.arena; }
+};
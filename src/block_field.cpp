@@ -0,0 +1,205 @@
+#include "block_field.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+	// Appends begin + the index of each set bit in mask.
+	uint32_t EmitHits(uint32_t mask, const uint32_t base, uint32_t* out, uint32_t count)
+	{
+		while (mask)
+		{
+			out[count++] = base + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+
+		return count;
+	}
+
+	// Mask of the lanes of a vector starting at I that are inside [I, end).
+	uint32_t RangeMask(const uint32_t I, const uint32_t end)
+	{
+		const uint32_t remaining = end - I;
+		return remaining >= BlockFieldLanes ? 0xFF : (1u << remaining) - 1;
+	}
+}
+
+void BlockField::Assign(const std::vector<LevelBlock>& blocks)
+{
+	count		= uint32_t(blocks.size());
+	aliveCount	= count;
+
+	const size_t padded = count + BlockFieldLanes;
+
+	x.assign(padded, 0.0f);
+	y.assign(padded, 0.0f);
+	halfW.assign(padded, 0.0f);
+	halfH.assign(padded, 0.0f);
+
+	hp.resize(count);
+	type.resize(count);
+	color.resize(count);
+
+	for (uint32_t I = 0; I < count; I++)
+	{
+		x[I]		= blocks[I].x;
+		y[I]		= blocks[I].y;
+		halfW[I]	= blocks[I].w / 2.0f;
+		halfH[I]	= blocks[I].h / 2.0f;
+
+		hp[I]		= blocks[I].hp;
+		type[I]		= blocks[I].type;
+		color[I]	= blocks[I].color;
+	}
+
+	// One spare word so AliveBits8 can always read the next word.
+	alive.assign(count / 32 + 2, 0);
+
+	for (uint32_t I = 0; I < count; I++)
+		alive[I >> 5] |= 1u << (I & 31);
+}
+
+// All variants compute, per block:
+//   ex = max(|cx - x| - halfW, 0), ey = max(|cy - y| - halfH, 0)
+//   hit = ex * ex + ey * ey <= r * r
+// which is the distance from the circle centre to the closest point of the
+// rectangle, without branches.
+
+uint32_t CircleBlockOverlapsScalar(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out)
+{
+	const float r2 = circle.r * circle.r;
+
+	uint32_t count = 0;
+
+	for (uint32_t I = begin; I < end; I++)
+	{
+		const float ex = std::max(std::abs(circle.x - blocks.x[I]) - blocks.halfW[I], 0.0f);
+		const float ey = std::max(std::abs(circle.y - blocks.y[I]) - blocks.halfH[I], 0.0f);
+
+		if (ex * ex + ey * ey <= r2 && blocks.IsAlive(I))
+			out[count++] = I;
+	}
+
+	return count;
+}
+
+#if defined(__SSE2__)
+uint32_t CircleBlockOverlapsSSE(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out)
+{
+	const __m128 cx		= _mm_set1_ps(circle.x);
+	const __m128 cy		= _mm_set1_ps(circle.y);
+	const __m128 r2		= _mm_set1_ps(circle.r * circle.r);
+	const __m128 zero	= _mm_setzero_ps();
+	const __m128 sign	= _mm_set1_ps(-0.0f);
+
+	uint32_t count = 0;
+
+	for (uint32_t I = begin; I < end; I += 4)
+	{
+		const __m128 dx = _mm_andnot_ps(sign, _mm_sub_ps(cx, _mm_loadu_ps(&blocks.x[I])));
+		const __m128 dy = _mm_andnot_ps(sign, _mm_sub_ps(cy, _mm_loadu_ps(&blocks.y[I])));
+		const __m128 ex = _mm_max_ps(_mm_sub_ps(dx, _mm_loadu_ps(&blocks.halfW[I])), zero);
+		const __m128 ey = _mm_max_ps(_mm_sub_ps(dy, _mm_loadu_ps(&blocks.halfH[I])), zero);
+		const __m128 d2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+		const uint32_t mask = uint32_t(_mm_movemask_ps(_mm_cmple_ps(d2, r2))) & RangeMask(I, end) & blocks.AliveBits8(I) & 0xF;
+
+		count = EmitHits(mask, I, out, count);
+	}
+
+	return count;
+}
+#endif
+
+#if defined(__AVX2__)
+uint32_t CircleBlockOverlapsAVX2(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out)
+{
+	const __m256 cx		= _mm256_set1_ps(circle.x);
+	const __m256 cy		= _mm256_set1_ps(circle.y);
+	const __m256 r2		= _mm256_set1_ps(circle.r * circle.r);
+	const __m256 zero	= _mm256_setzero_ps();
+	const __m256 sign	= _mm256_set1_ps(-0.0f);
+
+	uint32_t count = 0;
+
+	for (uint32_t I = begin; I < end; I += 8)
+	{
+		const __m256 dx = _mm256_andnot_ps(sign, _mm256_sub_ps(cx, _mm256_loadu_ps(&blocks.x[I])));
+		const __m256 dy = _mm256_andnot_ps(sign, _mm256_sub_ps(cy, _mm256_loadu_ps(&blocks.y[I])));
+		const __m256 ex = _mm256_max_ps(_mm256_sub_ps(dx, _mm256_loadu_ps(&blocks.halfW[I])), zero);
+		const __m256 ey = _mm256_max_ps(_mm256_sub_ps(dy, _mm256_loadu_ps(&blocks.halfH[I])), zero);
+
+		// Separate multiply and add, not FMA, to round exactly like the other variants.
+		const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+
+		const uint32_t mask = uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LE_OQ))) & RangeMask(I, end) & blocks.AliveBits8(I);
+
+		count = EmitHits(mask, I, out, count);
+	}
+
+	return count;
+}
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+uint32_t CircleBlockOverlapsNEON(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out)
+{
+	const float32x4_t cx	= vdupq_n_f32(circle.x);
+	const float32x4_t cy	= vdupq_n_f32(circle.y);
+	const float32x4_t r2	= vdupq_n_f32(circle.r * circle.r);
+	const float32x4_t zero	= vdupq_n_f32(0.0f);
+
+	// Lane bit weights for packing a compare result into a mask.
+	const uint32_t laneBitsInit[4] = { 1, 2, 4, 8 };
+	const uint32x4_t laneBits = vld1q_u32(laneBitsInit);
+
+	uint32_t count = 0;
+
+	for (uint32_t I = begin; I < end; I += 4)
+	{
+		const float32x4_t dx = vabsq_f32(vsubq_f32(cx, vld1q_f32(&blocks.x[I])));
+		const float32x4_t dy = vabsq_f32(vsubq_f32(cy, vld1q_f32(&blocks.y[I])));
+		const float32x4_t ex = vmaxq_f32(vsubq_f32(dx, vld1q_f32(&blocks.halfW[I])), zero);
+		const float32x4_t ey = vmaxq_f32(vsubq_f32(dy, vld1q_f32(&blocks.halfH[I])), zero);
+
+		// vmul + vadd rather than vmla, which would not round like the scalar path.
+		const float32x4_t d2 = vaddq_f32(vmulq_f32(ex, ex), vmulq_f32(ey, ey));
+
+		const uint32x4_t hit	= vandq_u32(vcleq_f32(d2, r2), laneBits);
+		const uint32x2_t pair	= vorr_u32(vget_low_u32(hit), vget_high_u32(hit));
+		const uint32_t	 bits	= vget_lane_u32(pair, 0) | vget_lane_u32(pair, 1);
+
+		const uint32_t mask = bits & RangeMask(I, end) & blocks.AliveBits8(I) & 0xF;
+
+		count = EmitHits(mask, I, out, count);
+	}
+
+	return count;
+}
+#endif
+
+uint32_t CircleBlockOverlaps(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out)
+{
+#if defined(__AVX2__)
+	return CircleBlockOverlapsAVX2(blocks, begin, end, circle, out);
+#elif defined(__SSE2__)
+	return CircleBlockOverlapsSSE(blocks, begin, end, circle, out);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return CircleBlockOverlapsNEON(blocks, begin, end, circle, out);
+#else
+	return CircleBlockOverlapsScalar(blocks, begin, end, circle, out);
+#endif
+}
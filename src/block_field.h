@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+#include "level.h"
+
+// Structure-of-arrays block storage. Positions and half extents live in
+// separate arrays and liveness in a bitmask, so overlap kernels can test
+// BlockFieldLanes blocks per instruction. Arrays are padded past count so
+// kernels may load whole vectors at the end of a range.
+
+enum {
+	BlockFieldLanes = 8
+};
+
+struct BlockField
+{
+	uint32_t				count		= 0;
+	uint32_t				aliveCount	= 0;
+
+	std::vector<float>		x;
+	std::vector<float>		y;
+	std::vector<float>		halfW;
+	std::vector<float>		halfH;
+	std::vector<uint32_t>	alive;		// One bit per block
+
+	// Gameplay data, only read when a block is hit or drawn.
+	std::vector<uint16_t>	hp;
+	std::vector<uint8_t>	type;		// LevelBlockType
+	std::vector<uint32_t>	color;		// 0xRRGGBBAA
+
+	void Assign(const std::vector<LevelBlock>& blocks);
+
+	bool IsAlive(const uint32_t index) const
+	{
+		return (alive[index >> 5] >> (index & 31)) & 1;
+	}
+
+	void Kill(const uint32_t index)
+	{
+		alive[index >> 5] &= ~(1u << (index & 31));
+		aliveCount--;
+	}
+
+	Rect GetRect(const uint32_t index) const
+	{
+		return Rect{ x[index], y[index], halfW[index] * 2.0f, halfH[index] * 2.0f };
+	}
+
+	// Live bits for blocks index .. index + 7, in the low bits.
+	uint32_t AliveBits8(const uint32_t index) const
+	{
+		const uint32_t word		= index >> 5;
+		const uint32_t shift	= index & 31;
+
+		uint64_t bits = alive[word];
+		if (shift > 24)
+			bits |= uint64_t(alive[word + 1]) << 32;
+
+		return uint32_t(bits >> shift) & 0xFF;
+	}
+};
+
+// Writes the indices of live blocks in [begin, end) that overlap circle to
+// out, which must have room for end - begin entries, and returns how many
+// were written. Every variant uses the same arithmetic and gives identical
+// results; CircleBlockOverlaps is the fastest one compiled in.
+uint32_t CircleBlockOverlaps(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out);
+
+uint32_t CircleBlockOverlapsScalar(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out);
+
+#if defined(__SSE2__)
+uint32_t CircleBlockOverlapsSSE(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out);
+#endif
+
+#if defined(__AVX2__)
+uint32_t CircleBlockOverlapsAVX2(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out);
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+uint32_t CircleBlockOverlapsNEON(const BlockField& blocks, uint32_t begin, uint32_t end, const Circle& circle, uint32_t* out);
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+
+// 16.16 fixed-point number for the deterministic physics mode. Every
+// operation is integer arithmetic, so results are bit-identical on any
+// platform and never touch the FPU. Every result is computed in 64 bits and
+// saturates instead of overflowing.
+//
+// The helpers below are overloaded for float and Fixed, so simulation code
+// can be written once as a template over its scalar type.
+
+struct Fixed
+{
+	static constexpr int		FractionBits	= 16;
+	static constexpr int32_t	One				= 1 << FractionBits;
+
+	int32_t raw = 0;
+
+	constexpr Fixed() = default;
+
+	// Rounds to nearest. Only converts values that are already identical on
+	// every platform, such as constants, level data and the tick length.
+	explicit constexpr Fixed(const double value) : raw{ int32_t(value * One + (value < 0 ? -0.5 : 0.5)) } {}
+
+	static constexpr Fixed FromRaw(const int32_t raw)
+	{
+		Fixed value;
+		value.raw = raw;
+		return value;
+	}
+
+	static constexpr Fixed Saturate(const int64_t raw)
+	{
+		return FromRaw(int32_t(raw < INT32_MIN ? INT32_MIN : raw > INT32_MAX ? INT32_MAX : raw));
+	}
+
+	explicit operator float() const { return float(raw) * (1.0f / One); }
+
+	constexpr Fixed operator - () const { return Saturate(-int64_t(raw)); }
+
+	constexpr Fixed operator + (const Fixed rhs) const { return Saturate(int64_t(raw) + rhs.raw); }
+	constexpr Fixed operator - (const Fixed rhs) const { return Saturate(int64_t(raw) - rhs.raw); }
+	constexpr Fixed operator * (const Fixed rhs) const { return Saturate((int64_t(raw) * rhs.raw) >> FractionBits); }
+
+	Fixed operator / (const Fixed rhs) const
+	{
+		if (rhs.raw == 0)
+			return FromRaw(raw < 0 ? INT32_MIN : INT32_MAX);
+
+		return Saturate((int64_t(raw) * One) / rhs.raw);
+	}
+
+	Fixed& operator += (const Fixed rhs) { return *this = *this + rhs; }
+	Fixed& operator -= (const Fixed rhs) { return *this = *this - rhs; }
+	Fixed& operator *= (const Fixed rhs) { return *this = *this * rhs; }
+	Fixed& operator /= (const Fixed rhs) { return *this = *this / rhs; }
+
+	constexpr bool operator == (const Fixed rhs) const { return raw == rhs.raw; }
+	constexpr bool operator != (const Fixed rhs) const { return raw != rhs.raw; }
+	constexpr bool operator <  (const Fixed rhs) const { return raw <  rhs.raw; }
+	constexpr bool operator <= (const Fixed rhs) const { return raw <= rhs.raw; }
+	constexpr bool operator >  (const Fixed rhs) const { return raw >  rhs.raw; }
+	constexpr bool operator >= (const Fixed rhs) const { return raw >= rhs.raw; }
+};
+
+namespace FixedDetail
+{
+	// Integer square root of a 64 bit value, one result bit per step.
+	inline uint64_t Isqrt(uint64_t value)
+	{
+		uint64_t result	= 0;
+		uint64_t bit	= uint64_t(1) << 62;
+
+		while (bit > value)
+			bit >>= 2;
+
+		while (bit)
+		{
+			if (value >= result + bit)
+			{
+				value	-= result + bit;
+				result	 = (result >> 1) + bit;
+			}
+			else
+				result >>= 1;
+
+			bit >>= 2;
+		}
+
+		return result;
+	}
+
+	// sin(x) for x in [-pi/2, pi/2], Taylor series to x^7 (error below 1e-4).
+	inline Fixed SinQuadrant(const Fixed x)
+	{
+		const Fixed x2 = x * x;
+
+		return x * (Fixed(1.0) - x2 * (Fixed(1.0 / 6.0) - x2 * (Fixed(1.0 / 120.0) - x2 * Fixed(1.0 / 5040.0))));
+	}
+}
+
+inline float Abs(const float x)		{ return std::abs(x); }
+inline float Sqrt(const float x)	{ return std::sqrt(x); }
+inline float Floor(const float x)	{ return std::floor(x); }
+inline float Sin(const float x)		{ return std::sin(x); }
+inline float Cos(const float x)		{ return std::cos(x); }
+
+inline Fixed Abs(const Fixed x)		{ return x.raw < 0 ? -x : x; }
+inline Fixed Floor(const Fixed x)	{ return Fixed::FromRaw(x.raw & ~(Fixed::One - 1)); }
+
+inline Fixed Sqrt(const Fixed x)
+{
+	return x.raw <= 0 ? Fixed() : Fixed::FromRaw(int32_t(FixedDetail::Isqrt(uint64_t(x.raw) << Fixed::FractionBits)));
+}
+
+// Length of (x, y). The fixed version squares in 64 bits, so any pair of
+// coordinates works.
+inline float Length(const float x, const float y) { return std::sqrt(x * x + y * y); }
+
+inline Fixed Length(const Fixed x, const Fixed y)
+{
+	const uint64_t lengthSq = uint64_t(int64_t(x.raw) * x.raw) + uint64_t(int64_t(y.raw) * y.raw);
+
+	return Fixed::Saturate(int64_t(FixedDetail::Isqrt(lengthSq)));
+}
+
+inline Fixed Sin(Fixed x)
+{
+	const Fixed pi		= Fixed(3.14159265358979);
+	const Fixed twoPi	= Fixed(6.28318530717959);
+	const Fixed halfPi	= Fixed(1.57079632679490);
+
+	// Reduce to [-pi, pi], then fold into [-pi/2, pi/2].
+	x = x - twoPi * Floor((x + pi) / twoPi);
+
+	if (x > halfPi)
+		x = pi - x;
+	else if (x < -halfPi)
+		x = -pi - x;
+
+	return FixedDetail::SinQuadrant(x);
+}
+
+inline Fixed Cos(const Fixed x)
+{
+	return Sin(x + Fixed(1.57079632679490));
+}
+
+// First t at which the point (fx, fy) + t (dx, dy) is r from the origin,
+// or false when it never is.
+inline bool FirstCircleCrossing(const float fx, const float fy, const float dx, const float dy, const float r, float& t)
+{
+	const float a		= dx * dx + dy * dy;
+	const float b		= 2.0f * (fx * dx + fy * dy);
+	const float c		= fx * fx + fy * fy - r * r;
+
+	const float discriminant = b * b - 4.0f * a * c;
+	if (a <= 0.0f || discriminant < 0.0f)
+		return false;
+
+	t = (-b - std::sqrt(discriminant)) / (2.0f * a);
+	return true;
+}
+
+// The root does not change when every input is scaled alike, so inputs of
+// 128 px or more are halved until the squares fit in 16.16; the
+// discriminant's products then fit in 64 bits.
+inline bool FirstCircleCrossing(Fixed fx, Fixed fy, Fixed dx, Fixed dy, Fixed r, Fixed& t)
+{
+	const int64_t limit = int64_t(128) << Fixed::FractionBits;
+
+	int64_t largest = 0;
+	for (const Fixed value : { fx, fy, dx, dy, r })
+		largest = std::max(largest, value.raw < 0 ? -int64_t(value.raw) : int64_t(value.raw));
+
+	int shift = 0;
+	while ((largest >> shift) >= limit)
+		shift++;
+
+	for (Fixed* value : { &fx, &fy, &dx, &dy, &r })
+		value->raw >>= shift;
+
+	const Fixed a		= dx * dx + dy * dy;
+	const Fixed halfB	= fx * dx + fy * dy;
+	const Fixed c		= fx * fx + fy * fy - r * r;
+
+	const int64_t discriminant = int64_t(halfB.raw) * halfB.raw - int64_t(a.raw) * c.raw;
+	if (a.raw <= 0 || discriminant < 0)
+		return false;
+
+	const int64_t root = int64_t(FixedDetail::Isqrt(uint64_t(discriminant)));
+
+	t = Fixed::Saturate(((-int64_t(halfB.raw) - root) * Fixed::One) / a.raw);
+	return true;
+}
+
+// Smallest step worth dividing by.
+template<typename TY_SCALAR> TY_SCALAR ScalarEpsilon();
+template<> inline float ScalarEpsilon<float>() { return 1e-12f; }
+template<> inline Fixed ScalarEpsilon<Fixed>() { return Fixed::FromRaw(1); }
+
+inline float ToFloat(const float x) { return x; }
+inline float ToFloat(const Fixed x) { return float(x); }
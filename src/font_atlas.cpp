@@ -0,0 +1,60 @@
+#include "font_atlas.h"
+
+#include <cstdio>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+static_assert(sizeof(FontGlyph) == sizeof(stbtt_packedchar), "FontGlyph must mirror stbtt_packedchar");
+
+bool BuildFontAtlas(const uint8_t* ttfData, FontAtlas& atlas)
+{
+	stbtt_fontinfo font;
+
+	if (!stbtt_InitFont(&font, ttfData, 0))
+	{
+		printf("failed\n");
+		return false;
+	}
+
+	int ascent, descent, lineGap;
+	stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
+
+	atlas.pixelHeight	= FontPixelHeight;
+	atlas.ascent		= ascent * stbtt_ScaleForPixelHeight(&font, FontPixelHeight);
+
+	// Use the smallest atlas every glyph fits in.
+	const int sizes[][2] = { { 256, 256 }, { 512, 256 }, { 512, 512 }, { 1024, 512 }, { 1024, 1024 } };
+
+	for (auto& size : sizes)
+	{
+		atlas.width		= size[0];
+		atlas.height	= size[1];
+		atlas.alpha.assign(atlas.width * atlas.height, 0);
+
+		stbtt_pack_context context;
+		if (!stbtt_PackBegin(&context, atlas.alpha.data(), atlas.width, atlas.height, 0, 1, nullptr))
+			return false;
+
+		stbtt_pack_range range	= {};
+		range.font_size							= FontPixelHeight;
+		range.first_unicode_codepoint_in_range	= FontFirstChar;
+		range.num_chars							= FontCharCount;
+		range.chardata_for_range				= reinterpret_cast<stbtt_packedchar*>(atlas.glyphs);
+
+		const int packed = stbtt_PackFontRanges(&context, ttfData, 0, &range, 1);
+		stbtt_PackEnd(&context);
+
+		if (packed)
+			return true;
+	}
+
+	printf("font atlas too large\n");
+	return false;
+}
+
+void ExpandFontAtlas(const uint8_t* alpha, const int texelCount, uint32_t* pixels)
+{
+	for (int I = 0; I < texelCount; I++)
+		pixels[I] = 0xFFFFFF00u | alpha[I];
+}
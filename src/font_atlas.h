@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Rasterizes printable ASCII from a TrueType font into a single packed
+// alpha atlas. Has no SDL dependency so host tools can use it too.
+
+enum {
+	FontFirstChar	= 32,
+	FontCharCount	= 95,	// ' ' through '~'
+	FontPixelHeight	= 64
+};
+
+// Same layout as stbtt_packedchar.
+struct FontGlyph
+{
+	uint16_t	x0, y0, x1, y1;		// Atlas rectangle
+	float		xoff, yoff;			// Top left offset from the pen position
+	float		xadvance;
+	float		xoff2, yoff2;		// Bottom right offset from the pen position
+};
+
+struct FontAtlas
+{
+	int			width;
+	int			height;
+	float		pixelHeight;
+	float		ascent;				// Pixels from the top of a line to the baseline
+
+	FontGlyph	glyphs[FontCharCount];
+
+	std::vector<uint8_t> alpha;		// width * height coverage values
+};
+
+bool BuildFontAtlas(const uint8_t* ttfData, FontAtlas& atlas);
+
+// White texels with coverage in alpha, as SDL_PIXELFORMAT_RGBA8888 values.
+void ExpandFontAtlas(const uint8_t* alpha, const int texelCount, uint32_t* pixels);
+
+// Pre-rasterized font file written by tools/fontbake at build time, loaded
+// with one read and one texture upload. Texels are stored as coverage only
+// and expanded to RGBA when the texture is created.
+enum {
+	BakedFontVersion = 2
+};
+
+struct BakedFontHeader
+{
+	char		magic[4];		// "BKFN"
+	uint32_t	version;
+	uint32_t	width;
+	uint32_t	height;
+	float		pixelHeight;
+	float		ascent;
+	uint32_t	firstChar;
+	uint32_t	charCount;
+
+	// Followed by charCount FontGlyphs and width * height coverage bytes.
+};
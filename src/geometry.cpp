@@ -0,0 +1,185 @@
+#include "geometry.h"
+#include "fixed.h"
+
+#include <algorithm>
+#include <cmath>
+
+float Distance(const float x1, const float y1, const float x2, const float y2)
+{
+	const float dx = x1 - x2;
+	const float dy = y1 - y2;
+
+	return sqrt(dx * dx + dy * dy);
+}
+
+bool RectangleCircleIntersection(const Rect& rect, const Circle& circle)
+{
+	float circleDistance_x = std::abs(circle.x - rect.x);
+	float circleDistance_y = std::abs(circle.y - rect.y);
+
+	if (circleDistance_x > (rect.w/2 + circle.r)) { return false; }
+	if (circleDistance_y > (rect.h/2 + circle.r)) { return false; }
+
+	if (circleDistance_x <= (rect.w/2)) { return true; } 
+	if (circleDistance_y <= (rect.h/2)) { return true; }
+
+	float cornerDistance_sq = (circleDistance_x - rect.w/2) * (circleDistance_x - rect.w/2) + (circleDistance_y - rect.h/2)*(circleDistance_y - rect.h/2);
+
+	return (cornerDistance_sq <= (circle.r * circle.r));
+}
+
+template<typename TY_SCALAR>
+bool RectangleCircleContact(const RectT<TY_SCALAR>& rect, const CircleT<TY_SCALAR>& circle, BlockHitT<TY_SCALAR>& hit)
+{
+	using S = TY_SCALAR;
+
+	const S halfW = rect.w / S(2.0);
+	const S halfH = rect.h / S(2.0);
+
+	const S dx = circle.x - rect.x;
+	const S dy = circle.y - rect.y;
+
+	// Closest point on the rectangle, relative to its centre.
+	const S closestX = std::max(-halfW, std::min(dx, halfW));
+	const S closestY = std::max(-halfH, std::min(dy, halfH));
+
+	const S offsetX = dx - closestX;
+	const S offsetY = dy - closestY;
+
+	// Rejects far circles before squaring, which would overflow Fixed.
+	if (Abs(offsetX) > circle.r || Abs(offsetY) > circle.r)
+		return false;
+
+	const S distanceSq = offsetX * offsetX + offsetY * offsetY;
+
+	if (distanceSq > circle.r * circle.r)
+		return false;
+
+	if (distanceSq > S(0.0))
+	{
+		const S distance = Sqrt(distanceSq);
+
+		hit.penetration	= circle.r - distance;
+		hit.normalX		= offsetX / distance;
+		hit.normalY		= offsetY / distance;
+	}
+	else
+	{
+		// Centre inside the rectangle: push out through the nearest face.
+		const S faceX = halfW - Abs(dx);
+		const S faceY = halfH - Abs(dy);
+
+		if (faceX < faceY)
+		{
+			hit.penetration	= circle.r + faceX;
+			hit.normalX		= dx < S(0.0) ? S(-1.0) : S(1.0);
+			hit.normalY		= S(0.0);
+		}
+		else
+		{
+			hit.penetration	= circle.r + faceY;
+			hit.normalX		= S(0.0);
+			hit.normalY		= dy < S(0.0) ? S(-1.0) : S(1.0);
+		}
+	}
+
+	hit.time = S(0.0);
+	return true;
+}
+
+template<typename TY_SCALAR>
+bool SweptCircleRect(const RectT<TY_SCALAR>& rect, const CircleT<TY_SCALAR>& circle, const TY_SCALAR dx, const TY_SCALAR dy, TY_SCALAR& t, TY_SCALAR& nx, TY_SCALAR& ny)
+{
+	using S = TY_SCALAR;
+
+	BlockHitT<S> contact;
+
+	if (RectangleCircleContact(rect, circle, contact))
+	{
+		if (dx * contact.normalX + dy * contact.normalY >= S(0.0))
+			return false;
+
+		t	= S(0.0);
+		nx	= contact.normalX;
+		ny	= contact.normalY;
+		return true;
+	}
+
+	const S halfW = rect.w / S(2.0);
+	const S halfH = rect.h / S(2.0);
+
+	// Circle centre relative to the rectangle.
+	const S px = circle.x - rect.x;
+	const S py = circle.y - rect.y;
+
+	// Slab test of the centre against the rectangle grown by the radius.
+	S tEnter	= S(0.0);
+	S tExit		= S(1.0);
+	S enterNX	= S(0.0);
+	S enterNY	= S(0.0);
+
+	auto slab = [&](const S p, const S d, const S extent, const bool xAxis) -> bool
+	{
+		if (Abs(d) < ScalarEpsilon<S>())
+			return Abs(p) <= extent;
+
+		S t0 = (-extent - p) / d;
+		S t1 = ( extent - p) / d;
+		if (t0 > t1)
+			std::swap(t0, t1);
+
+		if (t0 > tEnter)
+		{
+			tEnter = t0;
+			enterNX = xAxis ? (d > S(0.0) ? S(-1.0) : S(1.0)) : S(0.0);
+			enterNY = xAxis ? S(0.0) : (d > S(0.0) ? S(-1.0) : S(1.0));
+		}
+
+		tExit = std::min(tExit, t1);
+		return tEnter <= tExit;
+	};
+
+	if (!slab(px, dx, halfW + circle.r, true) || !slab(py, dy, halfH + circle.r, false))
+		return false;
+
+	const S hitX = px + dx * tEnter;
+	const S hitY = py + dy * tEnter;
+
+	// Entered through a flat face.
+	if (Abs(hitX) <= halfW || Abs(hitY) <= halfH)
+	{
+		if (enterNX == S(0.0) && enterNY == S(0.0))
+			return false;
+
+		t	= tEnter;
+		nx	= enterNX;
+		ny	= enterNY;
+		return true;
+	}
+
+	// Entered the grown box in a corner region: intersect with the circle of
+	// radius r around that corner.
+	const S cornerX = hitX < S(0.0) ? -halfW : halfW;
+	const S cornerY = hitY < S(0.0) ? -halfH : halfH;
+
+	const S fx = px - cornerX;
+	const S fy = py - cornerY;
+
+	S tCorner;
+	if (!FirstCircleCrossing(fx, fy, dx, dy, circle.r, tCorner))
+		return false;
+
+	if (tCorner < S(0.0) || tCorner > S(1.0))
+		return false;
+
+	t	= tCorner;
+	nx	= (fx + dx * tCorner) / circle.r;
+	ny	= (fy + dy * tCorner) / circle.r;
+	return true;
+}
+
+template bool RectangleCircleContact<float>(const Rect&, const Circle&, BlockHit&);
+template bool RectangleCircleContact<Fixed>(const RectT<Fixed>&, const CircleT<Fixed>&, BlockHitT<Fixed>&);
+
+template bool SweptCircleRect<float>(const Rect&, const Circle&, const float, const float, float&, float&, float&);
+template bool SweptCircleRect<Fixed>(const RectT<Fixed>&, const CircleT<Fixed>&, const Fixed, const Fixed, Fixed&, Fixed&, Fixed&);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Shapes and narrow-phase tests shared by the simulation and its kernels.
+// The shapes and swept tests are templates over the scalar type, float or
+// Fixed (see fixed.h), and are instantiated for both in geometry.cpp.
+
+template<typename TY_SCALAR>
+struct RectT
+{
+	TY_SCALAR x;
+	TY_SCALAR y;
+
+	TY_SCALAR w;
+	TY_SCALAR h;
+};
+
+template<typename TY_SCALAR>
+struct CircleT
+{
+	TY_SCALAR x;
+	TY_SCALAR y;
+	TY_SCALAR r;
+};
+
+using Rect		= RectT<float>;
+using Circle	= CircleT<float>;
+
+float Distance(const float x1, const float y1, const float x2, const float y2);
+bool RectangleCircleIntersection(const Rect& rect, const Circle& circle);
+
+// One ball-block contact. The normal points from the block towards the ball.
+template<typename TY_SCALAR>
+struct BlockHitT
+{
+	uint32_t	index;
+	TY_SCALAR	penetration;
+	TY_SCALAR	normalX;
+	TY_SCALAR	normalY;
+	TY_SCALAR	time;		// Fraction of a sweep at first contact, 0 for static tests
+};
+
+using BlockHit = BlockHitT<float>;
+
+// Same test as RectangleCircleIntersection, also filling in the contact.
+template<typename TY_SCALAR>
+bool RectangleCircleContact(const RectT<TY_SCALAR>& rect, const CircleT<TY_SCALAR>& circle, BlockHitT<TY_SCALAR>& hit);
+
+// Swept test of a circle moving by dx, dy against a rectangle. On a hit, t is
+// the fraction of the move at first contact and nx, ny the contact normal.
+// A circle that already touches the rectangle hits at t = 0, unless it is
+// moving away from it.
+template<typename TY_SCALAR>
+bool SweptCircleRect(const RectT<TY_SCALAR>& rect, const CircleT<TY_SCALAR>& circle, const TY_SCALAR dx, const TY_SCALAR dy, TY_SCALAR& t, TY_SCALAR& nx, TY_SCALAR& ny);
@@ -0,0 +1,42 @@
+#include "level.h"
+
+#include <cstdio>
+#include <cstring>
+
+bool LoadLevel(const char* path, Level& level)
+{
+	FILE* levelFile = fopen(path, "rb");
+	if (!levelFile)
+		return false;
+
+	fseek(levelFile, 0, SEEK_END);
+	const long size = ftell(levelFile);
+	fseek(levelFile, 0, SEEK_SET);
+
+	level.data.resize(size_t(size > 0 ? size : 0));
+	const bool read = size > 0 && fread(level.data.data(), level.data.size(), 1, levelFile) == 1;
+	fclose(levelFile);
+
+	const LevelHeader* header = (const LevelHeader*)level.data.data();
+
+	const bool valid =
+		read && level.data.size() >= sizeof(LevelHeader) &&
+		memcmp(header->magic, "BKLV", 4) == 0 &&
+		header->version == LevelVersion &&
+		level.data.size() == sizeof(LevelHeader) + sizeof(LevelBlock) * size_t(header->blockCount);
+
+	if (!valid)
+	{
+		printf("%s is not a valid level\n", path);
+
+		level.data.clear();
+		level.blocks		= nullptr;
+		level.blockCount	= 0;
+		return false;
+	}
+
+	level.blocks		= (const LevelBlock*)(level.data.data() + sizeof(LevelHeader));
+	level.blockCount	= header->blockCount;
+
+	return true;
+}
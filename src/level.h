@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Compiled level file written by tools/levelc from a text source. A header
+// followed by packed block records; the loader reads it with one call and
+// the sim takes the block array straight from the buffer.
+
+enum {
+	LevelVersion = 1
+};
+
+enum LevelBlockType : uint8_t
+{
+	BlockNormal,
+	BlockMultiBall,		// Releases extra balls when broken
+
+	BlockTypeCount
+};
+
+struct LevelBlock
+{
+	float		x;		// Centre
+	float		y;
+	float		w;
+	float		h;
+	uint16_t	hp;		// Hits to break
+	uint8_t		type;	// LevelBlockType
+	uint8_t		pad;
+	uint32_t	color;	// 0xRRGGBBAA
+};
+
+struct LevelHeader
+{
+	char		magic[4];	// "BKLV"
+	uint32_t	version;
+	uint32_t	blockCount;
+	uint32_t	reserved;
+};
+
+static_assert(sizeof(LevelBlock) == 24, "LevelBlock is a file format record");
+static_assert(sizeof(LevelHeader) == 16, "LevelHeader is a file format record");
+
+// A loaded level file. blocks points into data.
+struct Level
+{
+	std::vector<uint8_t>	data;
+
+	const LevelBlock*		blocks		= nullptr;
+	uint32_t				blockCount	= 0;
+};
+
+bool LoadLevel(const char* path, Level& level);
@@ -0,0 +1,113 @@
+#include "level_gen.h"
+#include "sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Blocks fill this band at the top of the screen, leaving room to play.
+	const float areaTop		= 20.0f;
+	const float areaHeight	= SCREEN_HEIGHT * 0.35f;	// Stays clear of the ball at its start position
+	const float areaWidth	= float(SCREEN_WIDTH);
+	const float blockGap	= 0.1f;		// Fraction of a cell left empty between blocks
+	const float noiseScale	= 6.0f;		// Cells per noise lattice step
+
+	const uint32_t palette[] = { 0x8B7E74FF, 0x6F645CFF, 0xA4978EFF, 0xC7BCA1FF };
+
+	uint32_t Hash(uint32_t x, uint32_t y, const uint32_t seed)
+	{
+		uint32_t h = seed ^ (x * 0x8DA6B343u) ^ (y * 0xD8163841u);
+		h ^= h >> 16;
+		h *= 0x7FEB352Du;
+		h ^= h >> 15;
+		h *= 0x846CA68Bu;
+		h ^= h >> 16;
+
+		return h;
+	}
+
+	float HashUnit(const uint32_t x, const uint32_t y, const uint32_t seed)
+	{
+		return float(Hash(x, y, seed) >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Bilinear value noise in [0, 1), smoothed so it has no visible grid.
+	float ValueNoise(const float x, const float y, const uint32_t seed)
+	{
+		const float		fx	= std::floor(x);
+		const float		fy	= std::floor(y);
+		const uint32_t	ix	= uint32_t(fx);
+		const uint32_t	iy	= uint32_t(fy);
+
+		const float tx = x - fx;
+		const float ty = y - fy;
+		const float sx = tx * tx * (3.0f - 2.0f * tx);
+		const float sy = ty * ty * (3.0f - 2.0f * ty);
+
+		const float a = HashUnit(ix,     iy,     seed);
+		const float b = HashUnit(ix + 1, iy,     seed);
+		const float c = HashUnit(ix,     iy + 1, seed);
+		const float d = HashUnit(ix + 1, iy + 1, seed);
+
+		return (a + (b - a) * sx) + ((c + (d - c) * sx) - (a + (b - a) * sx)) * sy;
+	}
+}
+
+void GenerateLevel(const LevelGenParams& params, std::vector<LevelBlock>& blocks)
+{
+	blocks.clear();
+
+	const uint32_t	cells	= std::max(1u, std::min(params.blockCount, uint32_t(MaxGeneratedBlocks)));
+	const float		density	= std::max(0.0f, std::min(params.density, 1.0f));
+
+	// Pick a lattice with cells about as wide as they are tall.
+	const uint32_t	columns	= std::max(1u, uint32_t(std::ceil(std::sqrt(cells * areaWidth / areaHeight))));
+	const uint32_t	rows	= (cells + columns - 1) / columns;
+	const float		cellW	= areaWidth / columns;
+	const float		cellH	= areaHeight / rows;
+
+	blocks.reserve(cells);
+
+	for (uint32_t row = 0; row < rows; row++)
+	{
+		const bool		offset		= params.pattern == PatternBricks && (row & 1);
+		const uint32_t	rowColumns	= offset ? columns - 1 : columns;
+
+		for (uint32_t column = 0; column < rowColumns && blocks.size() < cells; column++)
+		{
+			const float keep = params.pattern == PatternNoise ?
+				ValueNoise(column / noiseScale, row / noiseScale, params.seed) :
+				HashUnit(column, row, params.seed);
+
+			if (keep >= density)
+				continue;
+
+			LevelBlock block;
+			block.x		= (column + (offset ? 1.0f : 0.5f)) * cellW;
+			block.y		= areaTop + (row + 0.5f) * cellH;
+			block.w		= cellW * (1.0f - blockGap);
+			block.h		= cellH * (1.0f - blockGap);
+			block.hp	= 1;
+			block.type	= BlockNormal;
+			block.pad	= 0;
+			block.color	= palette[row % (sizeof(palette) / sizeof(palette[0]))];
+
+			blocks.push_back(block);
+		}
+	}
+}
+
+LevelPattern ParseLevelPattern(const char* name)
+{
+	const char* names[] = { "grid", "bricks", "noise" };
+
+	for (int I = 0; I < PatternCount; I++)
+	{
+		if (strcmp(name, names[I]) == 0)
+			return LevelPattern(I);
+	}
+
+	return PatternCount;
+}
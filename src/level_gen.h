@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "level.h"
+
+// Seeded procedural levels, for stress scenes and finding where the game
+// stops scaling. Blocks fill the top of the screen on a regular lattice,
+// shrinking as the requested count grows; the same parameters always give
+// the same level.
+
+enum LevelPattern
+{
+	PatternGrid,		// Aligned rows and columns
+	PatternBricks,		// Every other row offset by half a block, like a brick wall
+	PatternNoise,		// Grid masked by smooth value noise, leaving clumps and holes
+
+	PatternCount
+};
+
+struct LevelGenParams
+{
+	uint32_t		seed		= 1;
+	LevelPattern	pattern		= PatternBricks;
+	uint32_t		blockCount	= 1000;		// Lattice cells; the level holds about blockCount * density blocks
+	float			density		= 1.0f;		// Fraction of cells that get a block
+};
+
+enum {
+	MaxGeneratedBlocks = 100000
+};
+
+void GenerateLevel(const LevelGenParams& params, std::vector<LevelBlock>& blocks);
+
+// Pattern by name ("grid", "bricks", "noise"), or PatternCount if unknown.
+LevelPattern ParseLevelPattern(const char* name);
@@ -0,0 +1,203 @@
+#include "log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	struct LogRing
+	{
+		LogRecord				records[LogRingCapacity];
+
+		std::atomic<uint32_t>	head{ 0 };	// Next slot the producer writes
+		std::atomic<uint32_t>	tail{ 0 };	// Next slot the consumer reads
+		std::atomic<uint32_t>	dropped{ 0 };
+	};
+
+	// Joins the worker if the process exits without LogShutdown, since
+	// destroying a joinable std::thread terminates.
+	struct LogWorker
+	{
+		~LogWorker() { LogShutdown(); }
+
+		std::thread thread;
+	};
+
+	LogRing				ring;
+	std::atomic<bool>	running{ false };
+	Uint64				startTicks = 0;
+	LogWorker			worker;		// Last, so it is destroyed first
+
+	const char* levelNames[] = { "D", "I", "W", "E" };
+
+	// Formats one record by handing each conversion specifier to snprintf
+	// with its argument, so the format string is never trusted with the
+	// wrong argument type.
+	void FormatRecord(const LogRecord& record, char* out, const size_t size)
+	{
+		size_t		length	= 0;
+		int			arg		= 0;
+		const char*	c		= record.format;
+
+		auto append = [&](const int written)
+		{
+			if (written > 0)
+				length = std::min(length + size_t(written), size - 1);
+		};
+
+		while (*c && length < size - 1)
+		{
+			if (*c != '%')
+			{
+				out[length++] = *c++;
+				continue;
+			}
+
+			if (c[1] == '%')
+			{
+				out[length++] = '%';
+				c += 2;
+				continue;
+			}
+
+			// Copy one specifier's flags, width and precision. Length modifiers
+			// are dropped since the stored argument type is known.
+			char spec[16];
+			size_t specLength = 0;
+
+			spec[specLength++] = *c++;
+			while (*c && !strchr("diouxXeEfgGcspaA", *c))
+			{
+				if (!strchr("hlLqjzt", *c) && specLength < sizeof(spec) - 1)
+					spec[specLength++] = *c;
+				c++;
+			}
+
+			const char conversion = *c ? *c++ : 's';
+			spec[specLength] = 0;
+
+			char*			dst		= out + length;
+			const size_t	left	= size - length;
+
+			if (arg >= record.argCount)
+			{
+				append(snprintf(dst, left, "<missing>"));
+				continue;
+			}
+
+			const LogArgType	type	= record.argTypes[arg];
+			const LogArg		value	= record.args[arg++];
+
+			char format[24];
+			switch (type)
+			{
+				case LogArgInt:
+				case LogArgUInt:
+					if (conversion == 'c')
+						append(snprintf(dst, left, "%c", int(value.i)));
+					else if (strchr("ouxX", conversion) || type == LogArgUInt)
+					{
+						snprintf(format, sizeof(format), "%sll%c", spec, strchr("ouxX", conversion) ? conversion : 'u');
+						append(snprintf(dst, left, format, value.u));
+					}
+					else
+					{
+						snprintf(format, sizeof(format), "%slld", spec);
+						append(snprintf(dst, left, format, value.i));
+					}
+					break;
+				case LogArgDouble:
+					snprintf(format, sizeof(format), "%s%c", spec, strchr("eEfgGaA", conversion) ? conversion : 'f');
+					append(snprintf(dst, left, format, value.d));
+					break;
+				case LogArgString:
+					snprintf(format, sizeof(format), "%ss", spec);
+					append(snprintf(dst, left, format, value.s ? value.s : "(null)"));
+					break;
+				case LogArgPointer:
+					append(snprintf(dst, left, "%p", value.p));
+					break;
+			}
+		}
+
+		out[length] = 0;
+	}
+
+	// Drains the ring, returns the number of records written.
+	size_t Flush()
+	{
+		const double toMs = 1000.0 / double(SDL_GetPerformanceFrequency());
+
+		uint32_t tail		= ring.tail.load(std::memory_order_relaxed);
+		const uint32_t head	= ring.head.load(std::memory_order_acquire);
+
+		size_t written = 0;
+
+		for (; tail != head; tail++, written++)
+		{
+			const LogRecord& record = ring.records[tail & (LogRingCapacity - 1)];
+
+			char message[512];
+			FormatRecord(record, message, sizeof(message));
+
+			fprintf(stdout, "[%10.3f %s] %s\n", double(record.ticks - startTicks) * toMs, levelNames[record.level], message);
+		}
+
+		ring.tail.store(tail, std::memory_order_release);
+
+		if (const uint32_t dropped = ring.dropped.exchange(0, std::memory_order_relaxed))
+			fprintf(stdout, "[log] dropped %u records\n", dropped);
+
+		if (written)
+			fflush(stdout);
+
+		return written;
+	}
+
+	void WorkerMain()
+	{
+		while (running.load(std::memory_order_acquire))
+		{
+			if (!Flush())
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		Flush();
+	}
+}
+
+void LogInit()
+{
+	if (running.exchange(true))
+		return;
+
+	startTicks = SDL_GetPerformanceCounter();
+
+	worker.thread = std::thread(WorkerMain);
+}
+
+void LogShutdown()
+{
+	if (!running.exchange(false))
+		return;
+
+	worker.thread.join();
+}
+
+void LogPush(const LogRecord& record)
+{
+	const uint32_t head = ring.head.load(std::memory_order_relaxed);
+
+	if (head - ring.tail.load(std::memory_order_acquire) >= LogRingCapacity)
+	{
+		ring.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	ring.records[head & (LogRingCapacity - 1)] = record;
+	ring.head.store(head + 1, std::memory_order_release);
+}
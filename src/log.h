@@ -0,0 +1,122 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Asynchronous logger. LOG_* calls copy the format string pointer and up to
+// LogMaxArgs raw arguments into a lock-free single-producer ring buffer; a
+// background thread does the printf-style formatting and writes to stdout.
+//
+// Only the main thread may log. Format strings and %s arguments must be
+// string literals or otherwise outlive the record. Records are dropped, and
+// counted, while the ring is full.
+//
+// Levels below BREAKOUT_LOG_LEVEL are compiled out. Release (NDEBUG) builds
+// default to LogLevelNone, which removes every call.
+
+enum LogLevel
+{
+	LogLevelDebug,
+	LogLevelInfo,
+	LogLevelWarning,
+	LogLevelError,
+	LogLevelNone
+};
+
+#ifndef BREAKOUT_LOG_LEVEL
+#ifdef NDEBUG
+#define BREAKOUT_LOG_LEVEL 4
+#else
+#define BREAKOUT_LOG_LEVEL 0
+#endif
+#endif
+
+enum {
+	LogMaxArgs			= 4,
+	LogRingCapacity		= 4096	// Must be a power of two
+};
+
+enum LogArgType : uint8_t
+{
+	LogArgInt,
+	LogArgUInt,
+	LogArgDouble,
+	LogArgString,
+	LogArgPointer
+};
+
+union LogArg
+{
+	long long			i;
+	unsigned long long	u;
+	double				d;
+	const char*			s;
+	const void*			p;
+};
+
+struct LogRecord
+{
+	Uint64		ticks;
+	const char*	format;
+	uint8_t		level;
+	uint8_t		argCount;
+	LogArgType	argTypes[LogMaxArgs];
+	LogArg		args[LogMaxArgs];
+};
+
+void LogInit();
+void LogShutdown();		// Flushes everything queued so far
+void LogPush(const LogRecord& record);
+
+inline void LogEncodeInt(LogRecord& r, const long long v)				{ r.argTypes[r.argCount] = LogArgInt;		r.args[r.argCount++].i = v; }
+inline void LogEncodeUInt(LogRecord& r, const unsigned long long v)		{ r.argTypes[r.argCount] = LogArgUInt;		r.args[r.argCount++].u = v; }
+
+inline void LogEncode(LogRecord& r, const int v)						{ LogEncodeInt(r, v); }
+inline void LogEncode(LogRecord& r, const long v)						{ LogEncodeInt(r, v); }
+inline void LogEncode(LogRecord& r, const long long v)					{ LogEncodeInt(r, v); }
+inline void LogEncode(LogRecord& r, const unsigned int v)				{ LogEncodeUInt(r, v); }
+inline void LogEncode(LogRecord& r, const unsigned long v)				{ LogEncodeUInt(r, v); }
+inline void LogEncode(LogRecord& r, const unsigned long long v)			{ LogEncodeUInt(r, v); }
+inline void LogEncode(LogRecord& r, const double v)						{ r.argTypes[r.argCount] = LogArgDouble;	r.args[r.argCount++].d = v; }
+inline void LogEncode(LogRecord& r, const char* v)						{ r.argTypes[r.argCount] = LogArgString;	r.args[r.argCount++].s = v; }
+inline void LogEncode(LogRecord& r, const void* v)						{ r.argTypes[r.argCount] = LogArgPointer;	r.args[r.argCount++].p = v; }
+
+template<typename... TY_ARGS>
+void LogWrite(const LogLevel level, const char* format, const TY_ARGS... args)
+{
+	static_assert(sizeof...(TY_ARGS) <= LogMaxArgs, "too many log arguments");
+
+	LogRecord record;
+	record.ticks	= SDL_GetPerformanceCounter();
+	record.format	= format;
+	record.level	= level;
+	record.argCount	= 0;
+
+	(LogEncode(record, args), ...);
+
+	LogPush(record);
+}
+
+#if BREAKOUT_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) LogWrite(LogLevelDebug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if BREAKOUT_LOG_LEVEL <= 1
+#define LOG_INFO(...) LogWrite(LogLevelInfo, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if BREAKOUT_LOG_LEVEL <= 2
+#define LOG_WARNING(...) LogWrite(LogLevelWarning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void)0)
+#endif
+
+#if BREAKOUT_LOG_LEVEL <= 3
+#define LOG_ERROR(...) LogWrite(LogLevelError, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
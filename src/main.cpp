@@ -1,386 +1,417 @@
-#include <psp2/kernel/processmgr.h>
-#include <psp2/ctrl.h>
-#include <psp2/kernel/clib.h>
-#include <sstream>
 #include <vector>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <SDL2/SDL.h>
 #include <algorithm>
-#include <string>
 
-#define STB_TRUETYPE_IMPLEMENTATION
-#include <stb_truetype.h>
+#include "arena.h"
+#include "level_gen.h"
+#include "log.h"
+#include "net.h"
+#include "netplay.h"
+#include "platform.h"
+#include "profiler.h"
+#include "render_batch.h"
+#include "replay.h"
+#include "scene.h"
+#include "snapshot.h"
+#include "text.h"
+#include "sim.h"
+
+SDL_Window    * gWindow   = NULL;
+SDL_Renderer  * gRenderer = NULL;
 
-//Screen dimension constants
 enum {
-	SCREEN_WIDTH  = 960,
-	SCREEN_HEIGHT = 544
+	FrameArenaSize		= 16 << 20,
+	ReplayReserveRuns	= 1 << 18,		// About an hour of constantly changing input
+	StickDeadZone		= 2048
 };
 
-SDL_Window    * gWindow   = NULL;
-SDL_Renderer  * gRenderer = NULL;
+enum GameMode
+{
+	Menu,
+	Game, 
+	Victory
+};
 
-void DrawCircle(SDL_Renderer* renderer, float x, float y, float radius = 50, char r= 255, char g = 255, char b= 255)
+struct GameState
 {
-	std::vector<SDL_Vertex> verts;
+	GameMode 	mode;
+	FontAsset	defaultFont;
 
-	for (size_t i = 0 ; i < 16; i++)
-	{
-		verts.emplace_back(SDL_Vertex 
-		                   { SDL_FPoint { 
-		                   x, y },
-						   SDL_Color { r, g, b, 255 }, 
-						   SDL_FPoint { 0 } });
-
-		verts.emplace_back(SDL_Vertex 
-		                   { SDL_FPoint { 
-		                   x + radius * sin((2.0f * 3.14159f) / 16.0f * float(i)), 
-		                   y + radius * cos((2.0f * 3.14159f) / 16.0f * float(i)), },
-						   SDL_Color { r, g, b, 255 }, 
-						   SDL_FPoint { 0 } });
-
-		verts.emplace_back(SDL_Vertex 
-		                   { SDL_FPoint { 
-		                   		x + radius * sin((2.0f * 3.14159f) / 16.0f * float(i + 1)), 
-		                   		y + radius * cos((2.0f * 3.14159f) / 16.0f * float(i + 1)), },
-							SDL_Color { r, g, b, 255 }, 
-							SDL_FPoint { 0 } });
-	}
+	float		tickRate	= 60.0f;	// Simulation ticks per second
+	float		renderRate	= 60.0f;	// Frame cap, may be lower than tickRate to save power
+	uint32_t	ballCount	= 1;		// Balls in play at the start of a game
 
-	SDL_RenderGeometry( renderer, nullptr, verts.data(), verts.size(), nullptr, 0 );
-}
+	Level		level;					// Empty when no level file loaded
 
-struct Rect
-{
-	float x;
-	float y;
+	bool			generateLevel	= false;	// Play a procedural level instead of the level file
+	LevelGenParams	levelGen;
 
-	float w;
-	float h;
-};
+	int			benchmarkFrames	= 0;		// Run the benchmark instead of the game when set
 
-struct FallingRect
-{	
-	Rect rect;
-	float v;
-};
+	bool			versus			= false;	// Play networked versus instead of single player
+	NetPlayer		netPlayer		= NetPlayerBottom;
+	uint16_t		netPort			= 0;		// Local port, 0 for any
+	char			netHost[64]		= {};		// Peer's address when joining
+	uint16_t		netHostPort		= 0;
+	uint32_t		inputDelay		= NetInputDelayTicks;
+	NetConditions	netConditions;				// Injected latency and loss, for testing
 
-struct Circle
-{
-	float x;
-	float y;
-	float r;
+	char		recordPath[256]	= {};	// Record every game here when set
+	bool		replaying		= false;	// Play replay back instead of reading the controller
+	Replay		replay;
+
+	bool		showProfiler = false;
+	char		tracePath[256];
+
+	FrameArena	frameArena{ FrameArenaSize };	// Reset at the top of every frame
 };
 
-float Distance(const float x1, const float y1, const float x2, const float y2)
+void MenuState(SDL_GameController* controller1, GameState& state);
+void PlayState(SDL_GameController* controller1, GameState& state);
+void VersusState(SDL_GameController* controller1, GameState& state);
+void VictoryState(SDL_GameController* controller1, GameState& state, const char* text);
+void UpdateTraceCombo(SDL_GameController* controller1, GameState& state);
+void QuitGame(GameState& state);
+
+// Rolling frame statistics in the top left corner, toggled with Select.
+void DrawProfilerHud(const FontAsset& font, FrameArena& arena)
 {
-	const float dx = x1 - x2;
-	const float dy = y1 - y2;
+	GeometryBatch hudBatch(&arena);
+	hudBatch.Reserve((ZoneHudCount + 1) * 64);
 
-	return sqrt(dx * dx + dy * dy);
-}
+	const float scale		= 0.25f;
+	const float lineHeight	= font.pixelHeight * scale;
 
-bool RectangleCircleIntersection(const Rect& rect, const Circle& circle)
-{
-	float circleDistance_x = abs(circle.x - rect.x);
-	float circleDistance_y = abs(circle.y - rect.y);
+	const SDL_Rect background = { 0, 0, 320, int(lineHeight * (ZoneHudCount + 1) + 8) };
+	SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 0xA0);
+	SDL_RenderFillRect(gRenderer, &background);
+
+	const SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
 
-	if (circleDistance_x > (rect.w/2 + circle.r)) { return false; }
-	if (circleDistance_y > (rect.h/2 + circle.r)) { return false; }
+	AddText(hudBatch, font, 4, 4, scale, "zone        min    avg    p99 ms", white);
 
-	if (circleDistance_x <= (rect.w/2)) { return true; } 
-	if (circleDistance_y <= (rect.h/2)) { return true; }
+	for (int zone = 0; zone < ZoneHudCount; zone++)
+	{
+		const ProfileStats stats = ProfilerGetStats(ProfileZoneId(zone));
 
-	float cornerDistance_sq = (circleDistance_x - rect.w/2) * (circleDistance_x - rect.w/2) + (circleDistance_y - rect.h/2)*(circleDistance_y - rect.h/2);
+		char line[64];
+		snprintf(line, sizeof(line), "%-10s %6.2f %6.2f %6.2f", ProfilerZoneName(ProfileZoneId(zone)), stats.minMs, stats.avgMs, stats.p99Ms);
 
-	return (cornerDistance_sq <= (circle.r * circle.r));
+		AddText(hudBatch, font, 4, 4 + lineHeight * (zone + 1), scale, line, white);
+	}
+
+	hudBatch.Flush(gRenderer, font.atlas);
 }
 
-enum GameMode
+void PlayState(SDL_GameController* controller1, GameState& state)
 {
-	Menu,
-	Game, 
-	Victory
-};
+	// How this game starts, kept so it can be recorded. A replay brings its
+	// own starting state instead.
+	Replay session;
+	session.tickDt		= 1.0f / state.tickRate;
+	session.ballCount	= state.ballCount;
 
-struct float2
-{
-	float x;
-	float y;
-};
+	if (state.generateLevel)
+	{
+		session.levelKind	= ReplayLevelGenerated;
+		session.levelGen	= state.levelGen;
+	}
+	else if (state.level.blockCount)
+	{
+		session.levelKind = ReplayLevelBlocks;
+		session.levelBlocks.assign(state.level.blocks, state.level.blocks + state.level.blockCount);
+	}
 
-struct float3
-{
-	float x;
-	float y;
-	float z;
-};
+	const bool		replaying	= state.replaying;
+	const bool		recording	= !replaying && state.recordPath[0];
+	const Replay&	start		= replaying ? state.replay : session;
 
+	ReplayPlayer player(state.replay);
+	bool		 replayEnded = false;
 
-struct FontAsset
-{
-	SDL_Texture* 	textures[256];
-	float3			wh[256];
-};
+	if (recording)
+		session.runs.reserve(ReplayReserveRuns);
 
-struct GameState
-{
-	GameMode 	mode;
-	FontAsset	defaultFont;
-};
+	BreakoutSim sim;
+	start.Start(sim);
 
-void MenuState(SDL_GameController* controller1, GameState& state);
-void PlayState(SDL_GameController* controller1, GameState& state);
-void VictoryState(SDL_GameController* controller1, GameState& state);
+	// Every tick is saved so holding Square can rewind the game. Recordings
+	// and replays must see every tick exactly once, so they cannot rewind.
+	const bool	rewindable	= !recording && !replaying;
+	SimHistory	history(sim);
+	history.Clear();
 
-void LoadFont(GameState& state)
-{
-	long size;
-	unsigned char* fontBuffer;
-	stbtt_fontinfo font;
+	const WorldState& world = sim.world;
 
-	FILE* fontFile = fopen("font.ttf", "rb");
+	SimStatus status = SimStatus::Running;
 
-	fseek(fontFile, 0, SEEK_END);
-	size = ftell(fontFile); /* how long is the file ? */
-	fseek(fontFile, 0, SEEK_SET); /* reset */
-    
-	fontBuffer = (unsigned char*)malloc(size);
+	const float	 tickDt		= start.tickDt;
+	const Uint64 frequency	= SDL_GetPerformanceFrequency();
+	const Uint64 frameTicks	= Uint64(frequency / state.renderRate);
 
-	fread(fontBuffer, size, 1, fontFile);
-	fclose(fontFile);
+	Uint64 lastTime		= SDL_GetPerformanceCounter();
+	float  accumulator	= 0.0f;
 
-	if (!stbtt_InitFont(&font, fontBuffer, 0))
+	bool back_Button_prev = false;
+
+	while (status == SimStatus::Running && !replayEnded)
 	{
-		printf("failed\n");
-	}
+		PROFILE_BEGIN_FRAME();
+
+		state.frameArena.Reset();
 
-	int b_w = 128; /* bitmap width */
-	int b_h = 32; /* bitmap height */
-	int l_h = 64; /* line height */
-	int baseline = 64; 
+		const Uint64 frameStart = SDL_GetPerformanceCounter();
 
-	struct RGBA
+		// Clamp long stalls so a hitch does not turn into a burst of catch-up ticks.
+		accumulator += std::min(float(frameStart - lastTime) / float(frequency), 0.25f);
+		lastTime = frameStart;
+
+		SimInput input;
+		bool	 rewinding = false;
+
+		{
+			PROFILE_ZONE(ZoneInput);
+
+			for(SDL_Event event; SDL_PollEvent(&event);){}
+		
+			// Stick drift near the centre would nudge the paddle and break up
+			// the long idle runs that keep recordings small.
+			const Sint16 axis = SDL_GameControllerGetAxis(controller1, SDL_CONTROLLER_AXIS_LEFTX);
+			input.paddleAxis = std::abs(int(axis)) < StickDeadZone ? 0 : axis;
+
+			const bool back_Button = SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_BACK) != 0;
+			if (back_Button && !back_Button_prev)
+				state.showProfiler = !state.showProfiler;
+
+			back_Button_prev = back_Button;
+
+			rewinding = rewindable && SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_X) != 0;
+
+			UpdateTraceCombo(controller1, state);
+		}
+
+		while (accumulator >= tickDt && status == SimStatus::Running)
+		{
+			if (rewinding)
+			{
+				if (history.NewestTick() > history.OldestTick())
+					history.Restore(history.NewestTick() - 1);
+
+				accumulator -= tickDt;
+				continue;
+			}
+
+			if (replaying && !player.Next(input))
+			{
+				replayEnded = true;
+				break;
+			}
+
+			if (recording)
+				session.Record(input);
+
+			status = history.Step(input, tickDt);
+			accumulator -= tickDt;
+		}
+
+		// Interpolating towards the tick being rewound away from would jitter.
+		const float alpha = rewinding ? 1.0f : std::min(accumulator / tickDt, 1.0f);
+
+		{
+			PROFILE_ZONE(ZoneRenderSubmit);
+
+			DrawWorld(gRenderer, world, alpha, tickDt, state.frameArena);
+
+			if (state.showProfiler)
+				DrawProfilerHud(state.defaultFont, state.frameArena);
+		}
+
+		{
+			PROFILE_ZONE(ZonePresent);
+			SDL_RenderPresent(gRenderer);
+		}
+
+		PROFILE_END_FRAME();
+
+		// Sleep off whatever is left of this frame's budget.
+		const Uint64 elapsed = SDL_GetPerformanceCounter() - frameStart;
+		if (elapsed < frameTicks)
+			SDL_Delay(Uint32((frameTicks - elapsed) * 1000 / frequency));
+	}
+
+	if (recording)
 	{
-		unsigned char R, G, B, A;
-	};
+		session.finalChecksum = WorldChecksum(world);
+		session.Write(state.recordPath);
+	}
 
-	const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_ ";
+	if (replaying)
+	{
+		if (player.Tick() == start.tickCount && WorldChecksum(world) == start.finalChecksum)
+			LOG_INFO("Replay matched the recording over %u ticks", player.Tick());
+		else
+			LOG_WARNING("Replay diverged from the recording after %u ticks", player.Tick());
+	}
 
-	for(size_t I = 0; I < sizeof(characters); I++)
+	if(status != SimStatus::Won)
 	{
-		char c = characters[I];
+		state.mode = GameMode::Menu;
+		return;
+	}
+	else
+		VictoryState(controller1, state, "Player Wins");
+}
 
-		auto fontBitmap = stbtt_GetCodepointBitmap(&font, 0, stbtt_ScaleForPixelHeight(&font, 64), c, &b_w, &b_h, 0, &baseline);
-		RGBA* bitmap = (RGBA*)malloc(sizeof(RGBA) * b_w * b_h);
+// Score and connection line along the top of a versus game.
+void DrawVersusHud(const FontAsset& font, FrameArena& arena, const NetplaySession& session, const WorldState& world, const GameState& state)
+{
+	GeometryBatch hudBatch(&arena);
+	hudBatch.Reserve(128);
 
-		for (size_t I = 0; I < b_w * b_h; I++)
-			bitmap[I] = RGBA{ fontBitmap[I], fontBitmap[I], fontBitmap[I], fontBitmap[I]};
+	const NetplayStats& stats = session.Stats();
 
-		SDL_Texture* texture = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, b_w, b_h);
-		SDL_UpdateTexture(texture, nullptr, bitmap, b_w * 4);
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	char line[128];
 
-		state.defaultFont.textures[c] 	= texture;
-		state.defaultFont.wh[c] 		= { b_w, b_h, baseline };
+	if (!session.Connected() && session.Player() == NetPlayerBottom)
+		snprintf(line, sizeof(line), "Waiting for player 2 on port %u", unsigned(state.netPort));
+	else if (!session.Connected())
+		snprintf(line, sizeof(line), "Joining %s:%u", state.netHost, unsigned(state.netHostPort));
+	else
+		snprintf(line, sizeof(line), "P1 %u - %u P2   you are P%d   rtt %u ms   rollback max %u%s",
+			world.score[0], world.score[1], int(session.Player()) + 1, stats.rttMs, stats.maxRollbackTicks, stats.desynced ? "   DESYNC" : "");
 
-		free(fontBitmap);
-		free(bitmap);
-	}	
+	const float scale = 0.25f;
+	AddText(hudBatch, font, 4, SCREEN_HEIGHT - font.pixelHeight * scale - 4, scale, line, SDL_Color{ 0x30, 0x30, 0x30, 0xFF });
 
+	hudBatch.Flush(gRenderer, font.atlas);
 }
 
-void PlayState(SDL_GameController* controller1, GameState& state)
+// Networked versus game, see NetplaySession. Player 1 hosts and waits for
+// player 2 to join; Circle gives up while waiting.
+void VersusState(SDL_GameController* controller1, GameState& state)
 {
-	const size_t paddleHeight	= 50;
-	const size_t paddleWidth 	= 100;
+	UdpLink link;
+	link.conditions = state.netConditions;
+
+	const bool hosting = state.netPlayer == NetPlayerBottom;
 
-	float t = 0.0f;
-	float paddleX = 0.5f * SCREEN_WIDTH - paddleWidth / 2;
-	float moveRate = 500.0f;
+	if (!PlatformNetInit() || !link.Open(state.netPort, hosting ? nullptr : state.netHost, state.netHostPort))
+	{
+		LOG_ERROR("Could not open the network link");
+		state.mode = GameMode::Menu;
+		return;
+	}
 
-	float ballX = float(SCREEN_WIDTH) / 2.0f;
-	float ballY	= float(SCREEN_HEIGHT) / 2.0f;
+	const float	 tickDt		= 1.0f / state.tickRate;
+	const Uint64 frequency	= SDL_GetPerformanceFrequency();
+	const Uint64 frameTicks	= Uint64(frequency / state.renderRate);
 
-	float ballX_V = 50.0f;
-	float ballY_V = 50.0f;
+	BreakoutSim		sim;
+	NetplaySession	session(sim, link, state.netPlayer, state.inputDelay, tickDt);
 
-	const float blockStepX = SCREEN_WIDTH / 12;
+	const WorldState& world = sim.world;
 
-	std::vector<Rect> blocks;
-	std::vector<FallingRect> fallingBlocks;
+	Uint64 lastTime		= SDL_GetPerformanceCounter();
+	float  accumulator	= 0.0f;
 
-	for(size_t I = 0; I < 10; I++)
-		blocks.push_back(Rect{ blockStepX + blockStepX * I, 50, blockStepX - 10, 50 });
-	
-	for(size_t I = 0; I < 9; I++)
-		blocks.push_back(Rect{ blockStepX * 1.5f + blockStepX * I, 110, blockStepX - 10, 50 });
+	// Keeps sending for a second after the end, so the peer gets the inputs
+	// it needs to confirm the end too.
+	const uint32_t	lingerFrames	= uint32_t(state.renderRate);
+	uint32_t		finishedFrames	= 0;
 
-	for(size_t I = 0; I < 10; I++)
-		blocks.push_back(Rect{ blockStepX + blockStepX * I, 170, blockStepX - 10, 50 });
+	bool back_Button_prev = false;
 
-	while (blocks.size())
+	while (finishedFrames < lingerFrames)
 	{
-		for(SDL_Event event; SDL_PollEvent(&event);){}
-		
-		const Sint16 x_axis = SDL_GameControllerGetAxis(controller1, SDL_CONTROLLER_AXIS_LEFTX);
+		PROFILE_BEGIN_FRAME();
 
-		const float x_relative = float(x_axis) / float(32768);
-		paddleX += x_relative / 16.0f * moveRate;
+		state.frameArena.Reset();
 
-		paddleX = std::max(0.0f, paddleX);
-		paddleX = std::min(float(SCREEN_WIDTH - paddleWidth), paddleX);
+		const Uint64	frameStart	= SDL_GetPerformanceCounter();
+		const uint32_t	nowMs		= SDL_GetTicks();
 
-		SDL_SetRenderDrawColor(gRenderer, 0xF1, 0xD3, 0xB3, 0xff);
-		SDL_RenderClear(gRenderer);
+		accumulator += std::min(float(frameStart - lastTime) / float(frequency), 0.25f);
+		lastTime = frameStart;
 
-		const int x = (int)(100 * cos(t / 10.0f));
-		const int y = (int)(100 * sin(t / 10.0f));
+		int16_t	axis	= 0;
+		bool	cancel	= false;
 
-		const SDL_Rect paddleRect = 
-		{ 	(int)paddleX,  
-			(int)SCREEN_HEIGHT - 100,
-			(int)paddleWidth, 
-			(int)paddleHeight
-		};
+		{
+			PROFILE_ZONE(ZoneInput);
 
-		ballX += 1.0f / 16.0f * ballX_V;
-		ballY += 1.0f / 16.0f * ballY_V;
+			for(SDL_Event event; SDL_PollEvent(&event);){}
 
-		if(ballY + 25 > SCREEN_HEIGHT)
-			break; // Player Lost!
+			const Sint16 stick = SDL_GameControllerGetAxis(controller1, SDL_CONTROLLER_AXIS_LEFTX);
+			axis = std::abs(int(stick)) < StickDeadZone ? 0 : stick;
 
-		if (ballX > SCREEN_WIDTH - 25.0f || ballX < 25.0f)
-		{
-			ballX = std::max(25.0f, ballX);
-			ballX = std::min(float(SCREEN_WIDTH) - 25.0f, ballX);
+			cancel = SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_B) != 0;
 
-			ballX_V = -ballX_V;
-		}
+			const bool back_Button = SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_BACK) != 0;
+			if (back_Button && !back_Button_prev)
+				state.showProfiler = !state.showProfiler;
 
-		if (ballY > SCREEN_HEIGHT - 25.0f || ballY < 25.0f)
-		{
-			ballY = std::max(25.0f, ballY);
-			ballY = std::min(float(SCREEN_HEIGHT) - 25.0f, ballY);
+			back_Button_prev = back_Button;
 
-			ballY_V = -ballY_V;
+			UpdateTraceCombo(controller1, state);
+
+			session.Receive(nowMs);
 		}
 
+		if (cancel && !session.Connected())
+			break;
 
-		for (auto& block : fallingBlocks)
+		if (session.TimedOut(nowMs))
 		{
-			block.v += 9.8 * 1.0f / 60.0f;
-			block.rect.y += block.v;
+			LOG_WARNING("Lost the connection to the other player");
+			break;
 		}
 
-		if (RectangleCircleIntersection(
-				Rect	{ paddleX + paddleWidth / 2.0f, SCREEN_HEIGHT - 100 + paddleHeight / 2.0f,  paddleWidth, paddleHeight }, 
-				Circle	{ ballX, ballY, 50.0f }))
-		{
-			if(0.0f < ballY_V)
-				ballY_V = -ballY_V;
-		}
-		
-		for (auto& block : blocks)
+		while (accumulator >= tickDt)
 		{
-			if (RectangleCircleIntersection(block, Circle { ballX, ballY, 50.0f }))
-			{
-				FallingRect fallingBlock;
-				fallingBlock.rect 	= block;
-				fallingBlock.v 		= 0.0f;
-				fallingBlocks.push_back(fallingBlock);
-			}
+			session.Advance(axis);
+			accumulator -= tickDt;
 		}
 
-		fallingBlocks.erase(
-			std::remove_if(fallingBlocks.begin(), fallingBlocks.end(), 
-			               [&](FallingRect& block) -> bool
-			               { 
-			               		return block.rect.y > SCREEN_HEIGHT + block.rect.h / 2.0f;  
-						   }),
-			fallingBlocks.end());
+		session.Send(nowMs);
 
-		
-		auto intersection_begin = std::remove_if(blocks.begin(), blocks.end(), 
-									[&](Rect& block) -> bool
-									{ 
-											return RectangleCircleIntersection(block, Circle{ ballX, ballY, 50.0f });  
-									});
+		if (session.Finished())
+			finishedFrames++;
 
-		
-		for (auto I = intersection_begin; I < blocks.end(); I++)
-		{
-			ballX_V *= 1.05f;
-			ballY_V *= 1.05f;
-		}
+		const float alpha = std::min(accumulator / tickDt, 1.0f);
 
-		if(std::distance(intersection_begin, blocks.end()) > 0)
 		{
-			auto I = intersection_begin;
-			float d = 0;
-			for(; I < blocks.end(); I++)
-			{
-				d = std::max(Distance(I->x, I->y, ballX, ballY), d);
-			}
+			PROFILE_ZONE(ZoneRenderSubmit);
 
-			const float diffX = abs( ballX - I->x ) - I->w / 2.0f;
-			const float diffY = abs( ballY - I->y ) - I->h / 2.0f;
+			DrawWorld(gRenderer, world, alpha, tickDt, state.frameArena);
+			DrawVersusHud(state.defaultFont, state.frameArena, session, world, state);
 
-			if(diffX > diffY)
-				ballX_V *= -1.0f;
-			else
-				ballY_V *= -1.0f;
+			if (state.showProfiler)
+				DrawProfilerHud(state.defaultFont, state.frameArena);
 		}
-		blocks.erase(intersection_begin, blocks.end());
 
-		SDL_SetRenderDrawColor(gRenderer, 0x8B, 0X7E, 0X74, 255);
-
-		for (auto& block : blocks)
 		{
-			const SDL_Rect blockRect = 
-			{ 	(int)block.x - block.w / 2,  
-				(int)block.y - block.h / 2,
-				(int)block.w, 
-				(int)block.h
-			};
-
-			SDL_RenderFillRect(gRenderer, &blockRect);
+			PROFILE_ZONE(ZonePresent);
+			SDL_RenderPresent(gRenderer);
 		}
 
-		SDL_SetRenderDrawColor(gRenderer, 0xC7, 0XBC, 0XA1, 255);
+		PROFILE_END_FRAME();
 
-		for (auto& block : fallingBlocks)
-		{
-			const SDL_Rect blockRect = 
-			{ 	(int)block.rect.x - block.rect.w / 2,  
-				(int)block.rect.y - block.rect.h / 2,
-				(int)block.rect.w, 
-				(int)block.rect.h
-			};
-
-			SDL_RenderFillRect(gRenderer, &blockRect);
-		}
-
-		printf("Ball Y Velocity: %i\n", (int)ballY_V);
-
-		DrawCircle(gRenderer, ballX, ballY, 50.0f, 0x65, 0x64, 0x7c);
-
-		SDL_SetRenderDrawColor(gRenderer, 0x61, 0x76, 0x4b, 255);
-		SDL_RenderFillRect(gRenderer, &paddleRect);
-
-		SDL_RenderPresent(gRenderer);
-		SDL_Delay(16);
-
-		t += 1.0f / 3.0f;
+		const Uint64 elapsed = SDL_GetPerformanceCounter() - frameStart;
+		if (elapsed < frameTicks)
+			SDL_Delay(Uint32((frameTicks - elapsed) * 1000 / frequency));
 	}
 
-	if(blocks.size())
+	if (!session.Finished())
 	{
 		state.mode = GameMode::Menu;
 		return;
 	}
-	else
-		VictoryState(controller1, state);
+
+	VictoryState(controller1, state, world.score[0] >= VersusWinScore ? "Player 1 Wins" : "Player 2 Wins");
 }
 
 template<typename TY>
@@ -389,25 +420,123 @@ TY Clamp(const TY min, const TY x, const TY max) noexcept
 	return std::max(std::min(x, max), min);
 }
 
-void DrawButton(const int x, const int y, const int w, const int h, const std::string& text, const SDL_Color& buttonColor, FontAsset& font)
+void DrawButton(const int x, const int y, const int w, const int h, const char* text, const SDL_Color& buttonColor, FontAsset& font)
 {
 	const SDL_Rect btnRect = { x, y, w, h };
 
 	SDL_SetRenderDrawColor(gRenderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
 	SDL_RenderFillRect(gRenderer, &btnRect);
 
-	const float textCharacterWidth = float(w * 0.9f) / float(text.size());
-	
-	float characterX = x + w / 20.0f;
+	// Fit the text to 90% of the button width and 80% of its height, centred.
+	const float textWidth	= std::max(MeasureText(font, text), 1.0f);
+	const float scale		= std::min(w * 0.9f / textWidth, h * 0.8f / font.pixelHeight);
+
+	DrawText(gRenderer, font,
+		x + (w - textWidth * scale) / 2.0f,
+		y + (h - font.pixelHeight * scale) / 2.0f,
+		scale, text, SDL_Color{ 0xFF, 0xFF, 0xFF, 0xFF });
+}
+
+void QuitGame(GameState& state)
+{
+	if (TraceIsRecording())
+	{
+		TraceStop();
+		TraceWrite(state.tracePath);
+	}
+
+	LogShutdown();
+
+	SDL_Quit();
+	PlatformExit(0);
+}
+
+// L + R starts recording a trace, pressing them again writes it out.
+void UpdateTraceCombo(SDL_GameController* controller1, GameState& state)
+{
+	static bool combo_prev = false;
+
+	const bool combo = 
+		SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_LEFTSHOULDER) != 0 &&
+		SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_RIGHTSHOULDER) != 0;
 
-	for(auto c : text)
+	if (combo && !combo_prev)
 	{
-		const float3 wh = font.wh[c];
-		const float scale = wh.x / wh.y;
-		const SDL_Rect characterRect = { characterX, y + w / 10.0f + scale * wh.z + scale * wh.y, textCharacterWidth, textCharacterWidth * scale };
-		characterX += textCharacterWidth;
+		if (TraceIsRecording())
+		{
+			TraceStop();
+			TraceWrite(state.tracePath);
+		}
+		else
+			TraceStart();
+	}
+
+	combo_prev = combo;
+}
+
+// Plays generated levels of growing size for a fixed number of frames each,
+// one tick per frame with the paddle following the first ball, and prints
+// the average sim, render submit and present time per frame.
+void RunBenchmark(GameState& state)
+{
+	const uint32_t	blockCounts[]	= { 100, 1000, 10000, 100000 };
+	const float		tickDt			= 1.0f / state.tickRate;
+	const double	msPerTick		= 1000.0 / double(SDL_GetPerformanceFrequency());
+
+	printf("%8s %8s %10s %10s %10s\n", "cells", "blocks", "sim ms", "submit ms", "present ms");
+
+	std::vector<LevelBlock> blocks;
+	BreakoutSim				sim;
+
+	for (const uint32_t cells : blockCounts)
+	{
+		LevelGenParams params	= state.levelGen;
+		params.blockCount		= cells;
+
+		GenerateLevel(params, blocks);
+		sim.Reset(blocks.data(), uint32_t(blocks.size()), state.ballCount);
+
+		const WorldState& world = sim.world;
+
+		Uint64 simTicks		= 0;
+		Uint64 submitTicks	= 0;
+		Uint64 presentTicks	= 0;
+
+		for (int frame = 0; frame < state.benchmarkFrames; frame++)
+		{
+			state.frameArena.Reset();
+
+			for (SDL_Event event; SDL_PollEvent(&event););
+
+			const float follow = world.balls.x[0] - (world.paddle.x + world.paddle.w / 2);
+
+			SimInput input;
+			input.paddleAxis = int16_t(Clamp(-32768.0f, follow * 2000.0f, 32767.0f));
+
+			const Uint64 simStart = SDL_GetPerformanceCounter();
+
+			if (sim.Step(input, tickDt) != SimStatus::Running)
+				sim.Reset(blocks.data(), uint32_t(blocks.size()), state.ballCount);
 
-		SDL_RenderCopy(gRenderer, font.textures[c], nullptr, &characterRect);
+			const Uint64 submitStart = SDL_GetPerformanceCounter();
+
+			DrawWorld(gRenderer, world, 1.0f, tickDt, state.frameArena);
+
+			const Uint64 presentStart = SDL_GetPerformanceCounter();
+
+			SDL_RenderPresent(gRenderer);
+
+			const Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+			simTicks		+= submitStart - simStart;
+			submitTicks		+= presentStart - submitStart;
+			presentTicks	+= frameEnd - presentStart;
+		}
+
+		const double frames = double(state.benchmarkFrames);
+
+		printf("%8u %8u %10.3f %10.3f %10.3f\n", cells, uint32_t(blocks.size()),
+			simTicks * msPerTick / frames, submitTicks * msPerTick / frames, presentTicks * msPerTick / frames);
 	}
 }
 
@@ -427,52 +556,59 @@ void MenuState(SDL_GameController* controller1, GameState& state)
 
 	while (true)
 	{
-		for (SDL_Event event; SDL_PollEvent(&event););
+		state.frameArena.Reset();
 
-		SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 255);
-		SDL_RenderClear(gRenderer);
+		{
+			PROFILE_ZONE(ZoneMenu);
 
-		const int buttonWidth 	= SCREEN_WIDTH / 5;
-		const int buttonHeight 	= 100;
+			for (SDL_Event event; SDL_PollEvent(&event););
+
+			UpdateTraceCombo(controller1, state);
+
+			SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 255);
+			SDL_RenderClear(gRenderer);
+
+			const int buttonWidth 	= SCREEN_WIDTH / 5;
+			const int buttonHeight 	= 100;
 		
-		DrawButton(
-			SCREEN_WIDTH / 2 - buttonWidth / 2, SCREEN_HEIGHT / 5 * 1, buttonWidth, buttonHeight, "Play", 
-			palette[menuSelection == 0 ? 0 : 3], state.defaultFont);
-		DrawButton(SCREEN_WIDTH / 2 - buttonWidth / 2, SCREEN_HEIGHT / 5 * 2, buttonWidth, buttonHeight, "Quit", 
-			palette[menuSelection == 1 ? 0 : 3], state.defaultFont);
+			DrawButton(
+				SCREEN_WIDTH / 2 - buttonWidth / 2, SCREEN_HEIGHT / 5 * 1, buttonWidth, buttonHeight, "Play", 
+				palette[menuSelection == 0 ? 0 : 3], state.defaultFont);
+			DrawButton(SCREEN_WIDTH / 2 - buttonWidth / 2, SCREEN_HEIGHT / 5 * 2, buttonWidth, buttonHeight, "Quit", 
+				palette[menuSelection == 1 ? 0 : 3], state.defaultFont);
 
-		SDL_RenderPresent(gRenderer);
+			SDL_RenderPresent(gRenderer);
 
-		const bool up_Button	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_DPAD_UP) != 0;
-		const bool down_Button	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_DPAD_DOWN) != 0;
-		const bool x_Button 	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_A) != 0;
+			const bool up_Button	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_DPAD_UP) != 0;
+			const bool down_Button	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_DPAD_DOWN) != 0;
+			const bool x_Button 	= SDL_GameControllerGetButton(controller1, SDL_CONTROLLER_BUTTON_A) != 0;
 
-		if(up_Button && !up_Button_prev)
-		{
-			printf("Up_Button down \n");
-			menuSelection = Clamp(0, menuSelection - 1, 1);
-		}
-		if(down_Button && !down_Button_prev)
-		{
-			printf("Down_Button down \n");
-			menuSelection = Clamp(0, menuSelection + 1, 1);
-		}
+			if(up_Button && !up_Button_prev)
+			{
+				LOG_DEBUG("Up_Button down");
+				menuSelection = Clamp(0, menuSelection - 1, 1);
+			}
+			if(down_Button && !down_Button_prev)
+			{
+				LOG_DEBUG("Down_Button down");
+				menuSelection = Clamp(0, menuSelection + 1, 1);
+			}
 
-		up_Button_prev = up_Button;
-		down_Button_prev = down_Button;
+			up_Button_prev = up_Button;
+			down_Button_prev = down_Button;
 
-		if(x_Button)
-		{
-			switch(menuSelection)
+			if(x_Button)
 			{
-				case 0:
-					state.mode = GameMode::Game;
-					return;
-					break;
-				case 1:
-					SDL_Quit();
-					sceKernelExitProcess(0);
-					break;
+				switch(menuSelection)
+				{
+					case 0:
+						state.mode = GameMode::Game;
+						return;
+						break;
+					case 1:
+						QuitGame(state);
+						break;
+				}
 			}
 		}
 
@@ -480,10 +616,12 @@ void MenuState(SDL_GameController* controller1, GameState& state)
 	}
 }
 
-void VictoryState(SDL_GameController* controller1, GameState& state)
+void VictoryState(SDL_GameController* controller1, GameState& state, const char* text)
 {
 	while (true)
 	{
+		state.frameArena.Reset();
+
 		SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 255);
 		SDL_RenderClear(gRenderer);
 
@@ -493,7 +631,7 @@ void VictoryState(SDL_GameController* controller1, GameState& state)
 		const int buttonHeight 	= 100;
 		
 		DrawButton(
-			SCREEN_WIDTH / 2 - 150 / 2, SCREEN_HEIGHT / 5 * 1, buttonWidth, buttonHeight, "Player Wins", 
+			SCREEN_WIDTH / 2 - 150 / 2, SCREEN_HEIGHT / 5 * 1, buttonWidth, buttonHeight, text, 
 			{ 0x00, 0x00, 0x00, 0x00 }, state.defaultFont);
 
 		SDL_RenderPresent(gRenderer);
@@ -510,20 +648,116 @@ void VictoryState(SDL_GameController* controller1, GameState& state)
 
 int main(int argc, char *argv[]) 
 {
+	PlatformInit();
+	LogInit();
+
 	if( SDL_Init( SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER ) < 0 )
+	{
+		LOG_ERROR("SDL_Init failed");
+		LogShutdown();
 		return -1;
+	}
 
 	if ((gWindow = SDL_CreateWindow( "RedRectangle", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN)) == NULL)
+	{
+		LOG_ERROR("Could not create the window");
+		LogShutdown();
+		SDL_Quit();
 		return -1;
+	}
 
-	if ((gRenderer = SDL_CreateRenderer( gWindow, -1, 0)) == NULL)
+	if ((gRenderer = SDL_CreateRenderer( gWindow, -1, PlatformRendererFlags())) == NULL)
+	{
+		LOG_ERROR("Could not create the renderer");
+		LogShutdown();
+		SDL_Quit();
 		return -1;
+	}
 
 	SDL_GameController* controller1 = SDL_GameControllerOpen(0);
-	printf("Hello: %i\n", (int)controller1 );
+	LOG_INFO("Hello: %p", (const void*)controller1);
 
 	GameState state;
-	LoadFont(state);
+	snprintf(state.tracePath, sizeof(state.tracePath), "%sbreakout_trace.json", PlatformDataDirectory());
+
+	const char* levelPath = "default.lvl";
+
+	for (int I = 1; I + 1 < argc; I += 2)
+	{
+		if (strcmp(argv[I], "--tick-rate") == 0)
+			state.tickRate = std::max(1.0f, float(atof(argv[I + 1])));
+		else if (strcmp(argv[I], "--render-rate") == 0)
+			state.renderRate = std::max(1.0f, float(atof(argv[I + 1])));
+		else if (strcmp(argv[I], "--balls") == 0)
+			state.ballCount = uint32_t(Clamp(1, atoi(argv[I + 1]), int(MaxBalls)));
+		else if (strcmp(argv[I], "--level") == 0)
+			levelPath = argv[I + 1];
+		else if (strcmp(argv[I], "--generate") == 0)
+		{
+			const LevelPattern pattern = ParseLevelPattern(argv[I + 1]);
+
+			state.generateLevel		= pattern != PatternCount;
+			state.levelGen.pattern	= state.generateLevel ? pattern : PatternBricks;
+		}
+		else if (strcmp(argv[I], "--blocks") == 0)
+			state.levelGen.blockCount = uint32_t(Clamp(1, atoi(argv[I + 1]), int(MaxGeneratedBlocks)));
+		else if (strcmp(argv[I], "--density") == 0)
+			state.levelGen.density = Clamp(0.0f, float(atof(argv[I + 1])), 1.0f);
+		else if (strcmp(argv[I], "--seed") == 0)
+			state.levelGen.seed = uint32_t(strtoul(argv[I + 1], nullptr, 10));
+		else if (strcmp(argv[I], "--benchmark") == 0)
+			state.benchmarkFrames = std::max(1, atoi(argv[I + 1]));
+		else if (strcmp(argv[I], "--record") == 0)
+			snprintf(state.recordPath, sizeof(state.recordPath), "%s", argv[I + 1]);
+		else if (strcmp(argv[I], "--replay") == 0)
+			state.replaying = state.replay.Load(argv[I + 1]);
+		else if (strcmp(argv[I], "--host") == 0)
+		{
+			state.versus	= true;
+			state.netPlayer	= NetPlayerBottom;
+			state.netPort	= uint16_t(atoi(argv[I + 1]));
+		}
+		else if (strcmp(argv[I], "--join") == 0)
+		{
+			// ADDRESS:PORT
+			snprintf(state.netHost, sizeof(state.netHost), "%s", argv[I + 1]);
+
+			char* port = strrchr(state.netHost, ':');
+			if (port)
+				*port++ = '\0';
+
+			state.versus		= port != nullptr;
+			state.netPlayer		= NetPlayerTop;
+			state.netHostPort	= port ? uint16_t(atoi(port)) : 0;
+		}
+		else if (strcmp(argv[I], "--input-delay") == 0)
+			state.inputDelay = uint32_t(Clamp(0, atoi(argv[I + 1]), int(MaxInputDelayTicks)));
+		else if (strcmp(argv[I], "--net-latency") == 0)
+			state.netConditions.latencyMs = uint32_t(std::max(0, atoi(argv[I + 1])));
+		else if (strcmp(argv[I], "--net-jitter") == 0)
+			state.netConditions.jitterMs = uint32_t(std::max(0, atoi(argv[I + 1])));
+		else if (strcmp(argv[I], "--net-loss") == 0)
+			state.netConditions.loss = Clamp(0.0f, float(atof(argv[I + 1])), 1.0f);
+		else if (strcmp(argv[I], "--trace") == 0)
+		{
+			snprintf(state.tracePath, sizeof(state.tracePath), "%s", argv[I + 1]);
+			TraceStart();
+		}
+	}
+
+	if (!LoadLevel(levelPath, state.level))
+		LOG_WARNING("Using the built-in level");
+
+	// The baked atlas is produced at build time; rasterizing the TrueType
+	// font is only a fallback for runs without it.
+	if (!LoadBakedFont(gRenderer, state.defaultFont, "font.bin"))
+		LoadFont(gRenderer, state.defaultFont, "font.ttf");
+
+	if (state.benchmarkFrames)
+	{
+		RunBenchmark(state);
+		QuitGame(state);
+	}
 
 	state.mode = GameMode::Menu;
 
@@ -534,7 +768,10 @@ int main(int argc, char *argv[])
 				MenuState(controller1, state);
 				break;
 			case GameMode::Game:
-				PlayState(controller1, state);
+				if (state.versus)
+					VersusState(controller1, state);
+				else
+					PlayState(controller1, state);
 				break;
 		}
 
@@ -544,8 +781,7 @@ int main(int argc, char *argv[])
 	gWindow = NULL;
 	gRenderer = NULL;
 
-	SDL_Quit();
-	sceKernelExitProcess(0);
+	QuitGame(state);
 
 	return 0;
 }
@@ -0,0 +1,153 @@
+#include "net.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+
+UdpLink::~UdpLink()
+{
+	Close();
+}
+
+bool UdpLink::Open(const uint16_t localPort, const char* remoteHost, const uint16_t remotePort)
+{
+	Close();
+
+	hasPeer = false;
+
+	if (remoteHost)
+	{
+		in_addr address;
+		if (inet_pton(AF_INET, remoteHost, &address) != 1)
+			return false;
+
+		hasPeer		= true;
+		peerAddress	= address.s_addr;
+		peerPort	= htons(remotePort);
+	}
+
+	handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle < 0)
+		return false;
+
+	sockaddr_in local = {};
+	local.sin_family		= AF_INET;
+	local.sin_addr.s_addr	= htonl(INADDR_ANY);
+	local.sin_port			= htons(localPort);
+
+	if (bind(handle, (const sockaddr*)&local, sizeof(local)) < 0)
+	{
+		Close();
+		return false;
+	}
+
+	delayed.assign(MaxDelayedDatagrams, Delayed{});
+	return true;
+}
+
+void UdpLink::Close()
+{
+	if (handle >= 0)
+		close(handle);
+
+	handle = -1;
+}
+
+void UdpLink::Send(const void* data, const size_t size, const uint32_t nowMs)
+{
+	if (handle < 0 || !hasPeer || size > MaxDatagramSize)
+		return;
+
+	if (conditions.loss > 0.0f && float(Random() >> 8) * (1.0f / 16777216.0f) < conditions.loss)
+		return;
+
+	if (!conditions.latencyMs && !conditions.jitterMs)
+	{
+		SendNow(data, size);
+		return;
+	}
+
+	const uint32_t jitter = conditions.jitterMs ? Random() % (conditions.jitterMs + 1) : 0;
+
+	for (Delayed& slot : delayed)
+	{
+		if (slot.size)
+			continue;
+
+		slot.sendAtMs	= nowMs + conditions.latencyMs + jitter;
+		slot.size		= uint32_t(size);
+		memcpy(slot.data, data, size);
+		return;
+	}
+
+	// Every slot is taken: the injected link is saturated and drops it.
+}
+
+void UdpLink::Update(const uint32_t nowMs)
+{
+	for (Delayed& slot : delayed)
+	{
+		if (slot.size && int32_t(nowMs - slot.sendAtMs) >= 0)
+		{
+			SendNow(slot.data, slot.size);
+			slot.size = 0;
+		}
+	}
+}
+
+size_t UdpLink::Receive(void* data, const size_t capacity)
+{
+	if (handle < 0)
+		return 0;
+
+	while (true)
+	{
+		sockaddr_in from = {};
+		socklen_t fromSize = sizeof(from);
+
+		const ssize_t size = recvfrom(handle, data, capacity, MSG_DONTWAIT, (sockaddr*)&from, &fromSize);
+		if (size <= 0)
+			return 0;
+
+		if (!hasPeer)
+		{
+			senderAddress	= from.sin_addr.s_addr;
+			senderPort		= from.sin_port;
+			return size_t(size);
+		}
+
+		// Anyone else is ignored once the peer is known.
+		if (from.sin_addr.s_addr == peerAddress && from.sin_port == peerPort)
+			return size_t(size);
+	}
+}
+
+void UdpLink::AcceptSender()
+{
+	hasPeer		= true;
+	peerAddress	= senderAddress;
+	peerPort	= senderPort;
+}
+
+void UdpLink::SendNow(const void* data, const size_t size)
+{
+	sockaddr_in to = {};
+	to.sin_family		= AF_INET;
+	to.sin_addr.s_addr	= peerAddress;
+	to.sin_port			= peerPort;
+
+	sendto(handle, data, size, 0, (const sockaddr*)&to, sizeof(to));
+}
+
+uint32_t UdpLink::Random()
+{
+	// xorshift32
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+
+	return randomState;
+}
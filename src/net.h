@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Non-blocking UDP link between two peers, with a latency and loss injector
+// for testing netplay against a bad connection on one machine. The injector
+// holds each outgoing datagram back for latencyMs plus up to jitterMs and
+// drops a fraction of them, so two processes that both use it see a round
+// trip of twice the latency.
+
+enum {
+	MaxDatagramSize		= 512,
+	MaxDelayedDatagrams	= 256		// Datagrams the injector can hold at once
+};
+
+struct NetConditions
+{
+	uint32_t	latencyMs	= 0;
+	uint32_t	jitterMs	= 0;
+	float		loss		= 0.0f;		// Fraction of datagrams dropped, 0..1
+};
+
+class UdpLink
+{
+public:
+	UdpLink() = default;
+	~UdpLink();
+
+	UdpLink(const UdpLink&)					= delete;
+	UdpLink& operator = (const UdpLink&)	= delete;
+
+	// Binds localPort, or any free port for 0. With a remote host, an IPv4
+	// address, datagrams go there. Without one the link reads from anyone
+	// until AcceptSender picks the peer.
+	bool		Open(const uint16_t localPort, const char* remoteHost = nullptr, const uint16_t remotePort = 0);
+	void		Close();
+
+	bool		HasPeer() const { return hasPeer; }
+
+	// Makes the sender of the last datagram received the peer, and ignores
+	// everyone else from then on.
+	void		AcceptSender();
+
+	// Passes a datagram through the injector. Held datagrams go out in
+	// Update once they are due.
+	void		Send(const void* data, const size_t size, const uint32_t nowMs);
+	void		Update(const uint32_t nowMs);
+
+	// Reads one waiting datagram from the peer and returns its size, or 0
+	// when there is none.
+	size_t		Receive(void* data, const size_t capacity);
+
+	NetConditions conditions;
+
+private:
+	struct Delayed
+	{
+		uint32_t	sendAtMs;
+		uint32_t	size;		// 0 for a free slot
+		uint8_t		data[MaxDatagramSize];
+	};
+
+	void		SendNow(const void* data, const size_t size);
+	uint32_t	Random();
+
+	int						handle			= -1;
+
+	bool					hasPeer			= false;
+	uint32_t				peerAddress		= 0;	// Network byte order
+	uint16_t				peerPort		= 0;	// Network byte order
+	uint32_t				senderAddress	= 0;	// Of the last datagram, before there is a peer
+	uint16_t				senderPort		= 0;
+
+	std::vector<Delayed>	delayed;
+	uint32_t				randomState		= 0x2545F491;
+};
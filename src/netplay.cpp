@@ -0,0 +1,369 @@
+#include "netplay.h"
+#include "log.h"
+#include "profiler.h"
+#include "replay.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	enum {
+		PacketMagic		= 0xB7,
+		ProtocolVersion	= 2
+	};
+
+	enum PacketType : uint8_t
+	{
+		PacketHello,
+		PacketInputs
+	};
+
+	int8_t Quantize(const int16_t axis)
+	{
+		return int8_t(axis >> 8);
+	}
+
+	int16_t Dequantize(const int8_t value)
+	{
+		return int16_t(value * 256);
+	}
+
+	// Little-endian packet fields, bounds checked on read.
+	struct PacketWriter
+	{
+		uint8_t*	data;
+		size_t		size = 0;
+
+		void U8(const uint8_t value)	{ data[size++] = value; }
+		void U16(const uint16_t value)	{ U8(uint8_t(value)); U8(uint8_t(value >> 8)); }
+		void U32(const uint32_t value)	{ U16(uint16_t(value)); U16(uint16_t(value >> 16)); }
+	};
+
+	struct PacketReader
+	{
+		const uint8_t*	data;
+		size_t			size;
+		size_t			offset	= 0;
+		bool			ok		= true;
+
+		uint8_t U8()
+		{
+			if (offset >= size)
+			{
+				ok = false;
+				return 0;
+			}
+
+			return data[offset++];
+		}
+
+		uint16_t U16() { const uint16_t low = U8(); return uint16_t(low | U8() << 8); }
+		uint32_t U32() { const uint32_t low = U16(); return low | uint32_t(U16()) << 16; }
+	};
+}
+
+NetplaySession::NetplaySession(BreakoutSim& sim, UdpLink& link, const NetPlayer player, const uint32_t inputDelay, const float tickDt)
+	: sim{ sim }, link{ link }, history{ sim }, player{ player }, inputDelay{ std::min<uint32_t>(inputDelay, MaxInputDelayTicks) }, tickDt{ tickDt }
+{
+	sim.ResetVersus();
+	history.Clear();
+
+	// Ticks before the first delayed input run with the sticks centred.
+	localNewest = this->inputDelay;
+}
+
+void NetplaySession::Receive(const uint32_t nowMs)
+{
+	uint8_t data[MaxDatagramSize];
+
+	for (size_t size; (size = link.Receive(data, sizeof(data)));)
+	{
+		PacketReader packet{ data, size };
+
+		if (packet.U8() != PacketMagic)
+			continue;
+
+		const uint8_t type = packet.U8();
+
+		if (type == PacketHello)
+		{
+			const uint8_t	version		= packet.U8();
+			const uint8_t	peerPlayer	= packet.U8();
+			const uint32_t	peerTickUs	= packet.U32();
+			const uint8_t	peerFixed	= packet.U8();
+
+			if (!packet.ok)
+				continue;
+
+			// Float and fixed-point physics diverge on the first bounce.
+			if (version != ProtocolVersion || peerPlayer == player || peerTickUs != uint32_t(tickDt * 1e6f) || peerFixed != BREAKOUT_FIXED_POINT)
+			{
+				if (!rejectedPeer)
+					LOG_WARNING("Ignoring a peer with different game settings");
+
+				rejectedPeer = true;
+				continue;
+			}
+
+			if (!link.HasPeer())
+				link.AcceptSender();
+		}
+		else if (type == PacketInputs)
+		{
+			// Only from a peer whose hello was accepted, or the one joined.
+			if (!link.HasPeer())
+				continue;
+
+			const uint32_t	sendMs		= packet.U32();
+			const uint32_t	echoMs		= packet.U32();
+			const uint16_t	heldMs		= packet.U16();
+			const uint32_t	tick		= packet.U32();
+			const int8_t	advantage	= int8_t(packet.U8());
+			const uint32_t	ack			= packet.U32();
+			const uint32_t	sumTick		= packet.U32();
+			const uint32_t	sumValue	= packet.U32();
+			const uint32_t	firstTick	= packet.U32();
+			const uint8_t	count		= packet.U8();
+
+			int8_t inputs[MaxPacketInputs];
+			int8_t value = 0;
+
+			for (uint32_t I = 0; I < count && I < MaxPacketInputs; I++)
+			{
+				value		= I ? int8_t(value + int8_t(packet.U8())) : int8_t(packet.U8());
+				inputs[I]	= value;
+			}
+
+			if (!packet.ok || count > MaxPacketInputs)
+				continue;
+
+			if (echoMs)
+				stats.rttMs = nowMs - echoMs - heldMs;
+
+			peerSendMs		= sendMs;
+			peerReceivedMs	= nowMs;
+
+			remoteTick		= std::max(remoteTick, tick);
+			remoteAdvantage	= advantage;
+			remoteAck		= std::max(remoteAck, ack);
+
+			if (sumTick > peerChecksum.tick)
+				peerChecksum = TickChecksum{ sumTick, sumValue };
+
+			ReceiveInputs(firstTick, count, inputs);
+		}
+		else
+			continue;
+
+		if (!connected)
+			LOG_INFO("Connected as player %d", int(player) + 1);
+
+		connected		= true;
+		lastReceiveMs	= nowMs;
+	}
+
+	Rollback();
+	CheckDesync();
+	CheckFinished();
+}
+
+bool NetplaySession::Advance(const int16_t localAxis)
+{
+	if (!connected || finished)
+		return false;
+
+	Rollback();
+
+	// The game ended on a predicted tick: hold there until it is confirmed
+	// or rolled back.
+	if (sim.Status() != SimStatus::Running)
+		return false;
+
+	const uint32_t next = sim.world.tick + 1;
+
+	if (next > remoteNewest + MaxPredictionTicks)
+	{
+		stats.stalledTicks++;
+		return false;
+	}
+
+	// Each peer sees the other's tick one trip late, so with both in step
+	// their advantages match. A peer that is ahead on average over a sync
+	// interval gives up a tick.
+	syncDifference += int32_t(sim.world.tick - remoteTick) - remoteAdvantage;
+
+	if (++ticksSinceSync >= NetSyncInterval)
+	{
+		const bool ahead = syncDifference >= 2 * int32_t(NetSyncInterval);
+
+		ticksSinceSync	= 0;
+		syncDifference	= 0;
+
+		if (ahead)
+		{
+			stats.syncSkips++;
+			return false;
+		}
+	}
+
+	localNewest = next + inputDelay;
+	localInputs[localNewest % NetInputRing] = Quantize(localAxis);
+
+	StepTick(next);
+	CheckFinished();
+
+	return true;
+}
+
+void NetplaySession::Send(const uint32_t nowMs)
+{
+	uint8_t		data[MaxDatagramSize];
+	PacketWriter packet{ data };
+
+	packet.U8(PacketMagic);
+
+	if (!connected)
+	{
+		if (link.HasPeer() && nowMs - lastHelloMs >= NetHelloIntervalMs)
+		{
+			packet.U8(PacketHello);
+			packet.U8(ProtocolVersion);
+			packet.U8(player);
+			packet.U32(uint32_t(tickDt * 1e6f));
+			packet.U8(BREAKOUT_FIXED_POINT);
+
+			link.Send(packet.data, packet.size, nowMs);
+			lastHelloMs = nowMs;
+		}
+
+		link.Update(nowMs);
+		return;
+	}
+
+	// The newest checksum no rollback can change any more.
+	TickChecksum sum = {};
+	for (const TickChecksum& entry : checksums)
+		if (entry.tick > sum.tick && entry.tick <= std::min(remoteNewest, sim.world.tick))
+			sum = entry;
+
+	const uint32_t first = remoteAck + 1;
+	const uint32_t count = localNewest >= first ? std::min<uint32_t>(localNewest - first + 1, MaxPacketInputs) : 0;
+
+	const int32_t advantage = int32_t(sim.world.tick - remoteTick);
+
+	packet.U8(PacketInputs);
+	packet.U32(nowMs);
+	packet.U32(peerSendMs);
+	packet.U16(uint16_t(std::min<uint32_t>(nowMs - peerReceivedMs, UINT16_MAX)));
+	packet.U32(sim.world.tick);
+	packet.U8(uint8_t(int8_t(std::max(-128, std::min(advantage, 127)))));
+	packet.U32(remoteNewest);
+	packet.U32(sum.tick);
+	packet.U32(sum.value);
+	packet.U32(first);
+	packet.U8(uint8_t(count));
+
+	for (uint32_t I = 0; I < count; I++)
+	{
+		const int8_t value = localInputs[(first + I) % NetInputRing];
+		const int8_t delta = I ? int8_t(value - localInputs[(first + I - 1) % NetInputRing]) : value;
+
+		packet.U8(uint8_t(delta));
+	}
+
+	link.Send(packet.data, packet.size, nowMs);
+	link.Update(nowMs);
+}
+
+void NetplaySession::ReceiveInputs(const uint32_t firstTick, const uint32_t count, const int8_t* inputs)
+{
+	for (uint32_t I = 0; I < count; I++)
+	{
+		const uint32_t tick = firstTick + I;
+
+		// Already have it, or a gap the peer will fill in a later packet.
+		if (tick <= remoteNewest)
+			continue;
+		if (tick != remoteNewest + 1)
+			break;
+
+		remoteInputs[tick % NetInputRing]	= inputs[I];
+		remoteNewest						= tick;
+
+		const bool mispredicted = tick <= sim.world.tick && usedRemote[tick % NetInputRing] != inputs[I];
+
+		if (mispredicted && (!rollbackFrom || tick < rollbackFrom))
+			rollbackFrom = tick;
+	}
+}
+
+void NetplaySession::Rollback()
+{
+	if (!rollbackFrom)
+		return;
+
+	PROFILE_ZONE(ZoneRollback);
+
+	const uint32_t current	= sim.world.tick;
+	const uint32_t from		= rollbackFrom;
+
+	rollbackFrom = 0;
+
+	if (!history.Restore(from - 1))
+	{
+		// Cannot happen while prediction stays inside the history.
+		stats.desynced = true;
+		return;
+	}
+
+	for (uint32_t tick = from; tick <= current && sim.Status() == SimStatus::Running; tick++)
+		StepTick(tick);
+
+	stats.rollbacks++;
+	stats.resimulatedTicks	+= current - from + 1;
+	stats.maxRollbackTicks	 = std::max(stats.maxRollbackTicks, current - from + 1);
+}
+
+void NetplaySession::StepTick(const uint32_t tick)
+{
+	const int8_t remote	= remoteInputs[std::min(tick, remoteNewest) % NetInputRing];
+	const int8_t local	= localInputs[tick % NetInputRing];
+
+	usedRemote[tick % NetInputRing] = remote;
+
+	SimInput input;
+	input.paddleAxis	= Dequantize(player == NetPlayerBottom ? local : remote);
+	input.topPaddleAxis	= Dequantize(player == NetPlayerBottom ? remote : local);
+
+	history.Step(input, tickDt);
+
+	// Recomputed if a rollback replays this tick, final once remoteNewest
+	// passes it.
+	if (tick % NetChecksumInterval == 0)
+		checksums[(tick / NetChecksumInterval) % NetChecksumRing] = TickChecksum{ tick, WorldChecksum(sim.world) };
+}
+
+void NetplaySession::CheckDesync()
+{
+	const TickChecksum peer = peerChecksum;
+
+	if (!peer.tick || peer.tick > remoteNewest || peer.tick > sim.world.tick)
+		return;
+
+	const TickChecksum& local = checksums[(peer.tick / NetChecksumInterval) % NetChecksumRing];
+
+	if (local.tick == peer.tick && local.value != peer.value && !stats.desynced)
+	{
+		LOG_WARNING("Desync detected at tick %u", peer.tick);
+		stats.desynced = true;
+	}
+
+	peerChecksum.tick = 0;
+}
+
+void NetplaySession::CheckFinished()
+{
+	if (!finished && sim.Status() != SimStatus::Running && sim.world.tick <= remoteNewest)
+		finished = true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+
+#include "net.h"
+#include "sim.h"
+#include "snapshot.h"
+
+// Two player versus over a UdpLink, using input delay and rollback. Both
+// peers run the whole simulation from the same start and exchange nothing
+// but their inputs.
+//
+// Local input is scheduled inputDelay ticks ahead, which hides that much
+// latency outright. Remote input that has not arrived yet is predicted to
+// repeat the last one that did; when the real input arrives and differs,
+// the sim is restored to the tick before it and simulated forward again.
+// Prediction stops MaxPredictionTicks past the newest remote input, which
+// bounds a re-simulation to that many ticks, and the session waits there.
+//
+// Sticks are quantized to 8 bits, for the wire and for the sim on both
+// peers. Every packet repeats all inputs the peer has not acknowledged, so
+// a lost packet only costs latency: the oldest one as a byte, then one
+// signed byte delta per tick.
+
+enum {
+	NetInputDelayTicks	= 3,		// Default input delay, 50 ms at 60 Hz
+	MaxInputDelayTicks	= 30,
+	MaxPredictionTicks	= 12,
+	NetInputRing		= 256,		// Ticks of input kept, well past any window
+	MaxPacketInputs		= 64,
+	NetChecksumInterval	= 30,		// Ticks between desync checks
+	NetChecksumRing		= 8,
+	NetSyncInterval		= 10,		// Ticks between time sync adjustments at most
+	NetHelloIntervalMs	= 100,
+	NetTimeoutMs		= 5000
+};
+
+enum NetPlayer : uint8_t
+{
+	NetPlayerBottom,	// Player 1, hosts the game
+	NetPlayerTop		// Player 2, joins it
+};
+
+struct NetplayStats
+{
+	uint32_t	rttMs				= 0;
+	uint32_t	rollbacks			= 0;
+	uint32_t	resimulatedTicks	= 0;
+	uint32_t	maxRollbackTicks	= 0;
+	uint32_t	stalledTicks		= 0;	// Ticks spent waiting for remote input
+	uint32_t	syncSkips			= 0;	// Ticks given up to let a slower peer catch up
+	bool		desynced			= false;
+};
+
+class NetplaySession
+{
+public:
+	// Resets sim to the start of a versus game.
+	NetplaySession(BreakoutSim& sim, UdpLink& link, const NetPlayer player, const uint32_t inputDelay, const float tickDt);
+
+	// Handles every waiting packet, rolling back when a remote input differs
+	// from its prediction. The first packet from the peer connects; a host
+	// only takes a peer whose hello has the same settings, physics mode
+	// included.
+	void		Receive(const uint32_t nowMs);
+
+	// Runs the next tick with this player's stick, unless the session has to
+	// wait for the remote or the game is over. Returns whether it ran.
+	bool		Advance(const int16_t localAxis);
+
+	// Sends a hello while connecting, then this player's unacknowledged
+	// inputs, and lets the link's injector release what is due.
+	void		Send(const uint32_t nowMs);
+
+	bool		Connected() const	{ return connected; }
+	bool		TimedOut(const uint32_t nowMs) const { return connected && nowMs - lastReceiveMs > NetTimeoutMs; }
+
+	// True once the game has ended on a tick both players' inputs are known
+	// for, so no rollback can undo it.
+	bool		Finished() const	{ return finished; }
+
+	NetPlayer			Player() const	{ return player; }
+	const NetplayStats&	Stats() const	{ return stats; }
+
+private:
+	struct TickChecksum
+	{
+		uint32_t tick;
+		uint32_t value;
+	};
+
+	void		ReceiveInputs(const uint32_t firstTick, const uint32_t count, const int8_t* inputs);
+	void		Rollback();
+	void		StepTick(const uint32_t tick);
+	void		CheckDesync();
+	void		CheckFinished();
+
+	BreakoutSim&	sim;
+	UdpLink&		link;
+	SimHistory		history;
+
+	const NetPlayer	player;
+	const uint32_t	inputDelay;
+	const float		tickDt;
+
+	bool			connected		= false;
+	bool			finished		= false;
+	bool			rejectedPeer	= false;	// Warned about a peer with other settings
+	uint32_t		lastReceiveMs	= 0;
+	uint32_t		lastHelloMs		= 0;
+
+	// Quantized inputs by tick % NetInputRing.
+	int8_t			localInputs[NetInputRing]	= {};
+	int8_t			remoteInputs[NetInputRing]	= {};
+	int8_t			usedRemote[NetInputRing]	= {};	// What the sim ran each tick with
+
+	uint32_t		localNewest		= 0;	// Newest tick with local input scheduled
+	uint32_t		remoteNewest	= 0;	// Newest tick with remote input, all before it too
+	uint32_t		remoteAck		= 0;	// Newest local input the peer has
+	uint32_t		rollbackFrom	= 0;	// Oldest mispredicted tick, 0 for none
+
+	// Time sync: how far each peer sees itself ahead of the other.
+	uint32_t		remoteTick			= 0;
+	int32_t			remoteAdvantage		= 0;
+	uint32_t		ticksSinceSync		= 0;
+	int32_t			syncDifference		= 0;	// Summed over the current sync interval
+
+	// Round trip: the peer's last send time, echoed back with how long it was held.
+	uint32_t		peerSendMs		= 0;
+	uint32_t		peerReceivedMs	= 0;
+
+	TickChecksum	checksums[NetChecksumRing]	= {};
+	TickChecksum	peerChecksum				= {};
+
+	NetplayStats	stats;
+};
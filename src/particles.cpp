@@ -0,0 +1,100 @@
+#include "particles.h"
+
+namespace
+{
+	const float shardHalfSize	= 4.0f;
+	const float shardSpeed		= 240.0f;	// Pixels per second, at most
+	const float shardLift		= 180.0f;	// Upward kick so shards arc before falling
+
+	// xorshift32, mapped to [0, 1).
+	float NextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return float(state >> 8) * (1.0f / 16777216.0f);
+	}
+}
+
+ParticlePool::ParticlePool()
+	: x(MaxParticles), y(MaxParticles), vx(MaxParticles), vy(MaxParticles), halfW(MaxParticles), halfH(MaxParticles), kind(MaxParticles)
+{
+}
+
+bool ParticlePool::Spawn(const float x_, const float y_, const float vx_, const float vy_, const float halfW_, const float halfH_, const ParticleKind kind_)
+{
+	if (count == MaxParticles)
+		return false;
+
+	x[count]		= x_;
+	y[count]		= y_;
+	vx[count]		= vx_;
+	vy[count]		= vy_;
+	halfW[count]	= halfW_;
+	halfH[count]	= halfH_;
+	kind[count]		= kind_;
+	count++;
+
+	return true;
+}
+
+void ParticlePool::Remove(const uint32_t index)
+{
+	const uint32_t last = --count;
+
+	x[index]		= x[last];
+	y[index]		= y[last];
+	vx[index]		= vx[last];
+	vy[index]		= vy[last];
+	halfW[index]	= halfW[last];
+	halfH[index]	= halfH[last];
+	kind[index]		= kind[last];
+}
+
+void UpdateParticles(ParticlePool& pool, const float gravity, const float dt)
+{
+	// Plain loops over restrict pointers with no branches, so the compiler
+	// vectorizes them for whichever SIMD width the target has.
+	float* __restrict		x	= pool.x.data();
+	float* __restrict		y	= pool.y.data();
+	float* __restrict		vy	= pool.vy.data();
+	const float* __restrict	vx	= pool.vx.data();
+
+	const uint32_t	count	= pool.count;
+	const float		dv		= gravity * dt;
+
+	for (uint32_t I = 0; I < count; I++)
+	{
+		vy[I]	+= dv;
+		x[I]	+= vx[I] * dt;
+		y[I]	+= vy[I] * dt;
+	}
+}
+
+void RemoveParticlesBelow(ParticlePool& pool, const float y)
+{
+	// Walk backwards so the particle swapped into a removed slot has
+	// already been tested.
+	for (uint32_t I = pool.count; I-- > 0;)
+	{
+		if (pool.y[I] - pool.halfH[I] > y)
+			pool.Remove(I);
+	}
+}
+
+void EmitBlockBreak(ParticlePool& pool, const Rect& block, const uint32_t shardCount)
+{
+	pool.Spawn(block.x, block.y, 0.0f, 0.0f, block.w / 2.0f, block.h / 2.0f, ParticleFallingBlock);
+
+	for (uint32_t I = 0; I < shardCount; I++)
+	{
+		// Shards start somewhere inside the block and fly away from its centre.
+		const float u = NextRandom(pool.seed) - 0.5f;
+		const float v = NextRandom(pool.seed) - 0.5f;
+		const float s = NextRandom(pool.seed) * shardSpeed;
+
+		if (!pool.Spawn(block.x + u * block.w, block.y + v * block.h, 2.0f * u * s, 2.0f * v * s - shardLift, shardHalfSize, shardHalfSize, ParticleShard))
+			break;
+	}
+}
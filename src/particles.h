@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+// Fixed-capacity structure-of-arrays particle storage, used for falling
+// blocks and the shards thrown off when a block breaks. Storage for
+// MaxParticles is allocated once; removing a particle moves the last one
+// into its slot, so live particles are always [0, count).
+
+enum {
+	MaxParticles = 16384
+};
+
+const uint32_t ParticleSeed = 0x9E3779B9;		// Emitter random state after a reset
+
+enum ParticleKind : uint8_t
+{
+	ParticleFallingBlock,
+	ParticleShard
+};
+
+struct ParticlePool
+{
+	uint32_t				count	= 0;
+	uint32_t				seed	= ParticleSeed;	// Emitter random state
+
+	std::vector<float>		x;		// Centre
+	std::vector<float>		y;
+	std::vector<float>		vx;
+	std::vector<float>		vy;
+	std::vector<float>		halfW;
+	std::vector<float>		halfH;
+	std::vector<uint8_t>	kind;
+
+	ParticlePool();
+
+	// Returns false, dropping the particle, when the pool is full.
+	bool Spawn(const float x, const float y, const float vx, const float vy, const float halfW, const float halfH, const ParticleKind kind);
+	void Remove(const uint32_t index);
+};
+
+// Applies gravity and moves every particle through one step.
+void UpdateParticles(ParticlePool& pool, const float gravity, const float dt);
+
+// Removes particles whose top edge is below y.
+void RemoveParticlesBelow(ParticlePool& pool, const float y);
+
+// Drops the block as a falling particle and throws shardCount shards out of it.
+void EmitBlockBreak(ParticlePool& pool, const Rect& block, const uint32_t shardCount);
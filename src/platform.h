@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// Thin layer over everything that differs between the Vita and the desktop
+// host build. The game itself only talks to SDL and these functions.
+
+void	PlatformInit();
+void	PlatformExit(int code);
+
+Uint32	PlatformRendererFlags();
+
+// Brings up networking for UdpLink. Safe to call more than once.
+bool	PlatformNetInit();
+
+// Writable directory for traces, recordings and other output, with a
+// trailing separator.
+const char*	PlatformDataDirectory();
@@ -0,0 +1,31 @@
+#include "platform.h"
+
+#include <cstdlib>
+
+void PlatformInit()
+{
+	// Always use SDL's software rasterizer on the host so frame costs are
+	// comparable between machines. Set SDL_VIDEODRIVER=offscreen to run
+	// without a display.
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+}
+
+void PlatformExit(int code)
+{
+	exit(code);
+}
+
+Uint32 PlatformRendererFlags()
+{
+	return SDL_RENDERER_SOFTWARE;
+}
+
+bool PlatformNetInit()
+{
+	return true;
+}
+
+const char* PlatformDataDirectory()
+{
+	return "";
+}
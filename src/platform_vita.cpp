@@ -0,0 +1,41 @@
+#include "platform.h"
+
+#include <psp2/kernel/processmgr.h>
+#include <psp2/ctrl.h>
+#include <psp2/net/net.h>
+#include <psp2/sysmodule.h>
+
+void PlatformInit()
+{
+}
+
+void PlatformExit(int code)
+{
+	sceKernelExitProcess(code);
+}
+
+Uint32 PlatformRendererFlags()
+{
+	return 0;
+}
+
+bool PlatformNetInit()
+{
+	static char netMemory[1 << 20];
+
+	if (sceSysmoduleLoadModule(SCE_SYSMODULE_NET) < 0)
+		return false;
+
+	SceNetInitParam param;
+	param.memory	= netMemory;
+	param.size		= sizeof(netMemory);
+	param.flags		= 0;
+
+	const int result = sceNetInit(&param);
+	return result >= 0 || result == int(SCE_NET_ERROR_EBUSY);
+}
+
+const char* PlatformDataDirectory()
+{
+	return "ux0:data/";
+}
@@ -0,0 +1,88 @@
+#include "profiler.h"
+
+#include <algorithm>
+
+namespace
+{
+	struct ProfilerState
+	{
+		Uint64	frameBegin;
+		Uint64	current[ZoneCount];
+		Uint64	history[ZoneCount][ProfileHistory];
+		int		head;
+		int		frames;
+	};
+
+	ProfilerState profiler;
+
+	const char* zoneNames[ZoneCount] = {
+		"frame",
+		"input",
+		"physics",
+		"collision",
+		"compaction",
+		"rollback",
+		"render",
+		"present",
+		"menu",
+		"load font",
+	};
+}
+
+const char* ProfilerZoneName(const ProfileZoneId zone)
+{
+	return zoneNames[zone];
+}
+
+void ProfilerBeginFrame()
+{
+	std::fill(profiler.current, profiler.current + ZoneCount, 0);
+	profiler.frameBegin = SDL_GetPerformanceCounter();
+
+	if (TraceIsRecording())
+		TraceRecord(ZoneFrame, 'B', profiler.frameBegin);
+}
+
+void ProfilerEndFrame()
+{
+	const Uint64 frameEnd = SDL_GetPerformanceCounter();
+	profiler.current[ZoneFrame] = frameEnd - profiler.frameBegin;
+
+	if (TraceIsRecording())
+		TraceRecord(ZoneFrame, 'E', frameEnd);
+
+	for (int zone = 0; zone < ZoneCount; zone++)
+		profiler.history[zone][profiler.head] = profiler.current[zone];
+
+	profiler.head	= (profiler.head + 1) % ProfileHistory;
+	profiler.frames	= std::min(profiler.frames + 1, int(ProfileHistory));
+}
+
+void ProfilerAddTime(const ProfileZoneId zone, const Uint64 ticks)
+{
+	profiler.current[zone] += ticks;
+}
+
+ProfileStats ProfilerGetStats(const ProfileZoneId zone)
+{
+	if (!profiler.frames)
+		return { 0, 0, 0 };
+
+	Uint64 samples[ProfileHistory];
+	std::copy(profiler.history[zone], profiler.history[zone] + profiler.frames, samples);
+
+	Uint64 total = 0;
+	for (int I = 0; I < profiler.frames; I++)
+		total += samples[I];
+
+	const int p99 = (profiler.frames * 99) / 100;
+	std::nth_element(samples, samples + p99, samples + profiler.frames);
+
+	const float toMs = 1000.0f / float(SDL_GetPerformanceFrequency());
+
+	return {
+		*std::min_element(samples, samples + profiler.frames) * toMs,
+		float(total) / float(profiler.frames) * toMs,
+		samples[p99] * toMs
+	};
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include "trace.h"
+
+// Scoped-zone frame profiler. Zone times are summed over a frame and kept for
+// the last ProfileHistory frames, so rolling statistics cost nothing until
+// someone asks for them. Build with -DBREAKOUT_PROFILE=0 to compile it out.
+
+#ifndef BREAKOUT_PROFILE
+#define BREAKOUT_PROFILE 1
+#endif
+
+enum ProfileZoneId
+{
+	ZoneFrame,
+	ZoneInput,
+	ZonePhysics,
+	ZoneCollision,
+	ZoneCompaction,
+	ZoneRollback,
+	ZoneRenderSubmit,
+	ZonePresent,
+
+	// Zones below are only recorded in traces, not shown in the HUD.
+	ZoneHudCount,
+	ZoneMenu = ZoneHudCount,
+	ZoneLoadFont,
+
+	ZoneCount
+};
+
+enum {
+	ProfileHistory = 256
+};
+
+struct ProfileStats
+{
+	float minMs;
+	float avgMs;
+	float p99Ms;
+};
+
+const char*		ProfilerZoneName(const ProfileZoneId zone);
+
+// ZoneFrame covers the time between these two calls.
+void			ProfilerBeginFrame();
+void			ProfilerEndFrame();
+
+void			ProfilerAddTime(const ProfileZoneId zone, const Uint64 ticks);
+ProfileStats	ProfilerGetStats(const ProfileZoneId zone);
+
+struct ProfileZone
+{
+	ProfileZone(const ProfileZoneId zone) : zone{ zone }, begin{ SDL_GetPerformanceCounter() }
+	{
+		if (TraceIsRecording())
+			TraceRecord(zone, 'B', begin);
+	}
+
+	~ProfileZone()
+	{
+		const Uint64 end = SDL_GetPerformanceCounter();
+
+		ProfilerAddTime(zone, end - begin);
+
+		if (TraceIsRecording())
+			TraceRecord(zone, 'E', end);
+	}
+
+	const ProfileZoneId	zone;
+	const Uint64		begin;
+};
+
+#if BREAKOUT_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(zone) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__){ zone }
+#define PROFILE_BEGIN_FRAME() ProfilerBeginFrame()
+#define PROFILE_END_FRAME() ProfilerEndFrame()
+#else
+#define PROFILE_ZONE(zone)
+#define PROFILE_BEGIN_FRAME()
+#define PROFILE_END_FRAME()
+#endif
@@ -0,0 +1,119 @@
+#include "render_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Tables for every segment count live back to back in one static array.
+	struct CircleTables
+	{
+		enum { PointCount = (MaxCircleSegments + 1) * (MaxCircleSegments + 2) / 2 };
+
+		SDL_FPoint	points[PointCount];
+		int			offsets[MaxCircleSegments + 1];
+
+		CircleTables()
+		{
+			int offset = 0;
+
+			for (int segments = 0; segments <= MaxCircleSegments; segments++)
+			{
+				offsets[segments] = offset;
+
+				for (int I = 0; I <= segments && segments >= MinCircleSegments; I++)
+				{
+					const float angle = (2.0f * 3.14159265f) / float(segments) * float(I);
+					points[offset++] = SDL_FPoint{ std::sin(angle), std::cos(angle) };
+				}
+			}
+		}
+	};
+
+	const CircleTables circleTables;
+
+	uint64_t submitCount = 0;
+}
+
+const SDL_FPoint* UnitCircle(int segments)
+{
+	segments = std::max(int(MinCircleSegments), std::min(segments, int(MaxCircleSegments)));
+
+	return circleTables.points + circleTables.offsets[segments];
+}
+
+GeometryBatch::GeometryBatch(FrameArena* arena)
+	: vertices(ArenaAllocator<SDL_Vertex>(arena)), indices(ArenaAllocator<int>(arena))
+{
+}
+
+void GeometryBatch::Reserve(const size_t quads)
+{
+	vertices.reserve(quads * 4);
+	indices.reserve(quads * 6);
+}
+
+void GeometryBatch::AddRect(const float x, const float y, const float w, const float h, const SDL_Color color)
+{
+	AddTexturedRect(x, y, w, h, 0, 0, 0, 0, color);
+}
+
+void GeometryBatch::AddTexturedRect(const float x, const float y, const float w, const float h,
+                                    const float u0, const float v0, const float u1, const float v1, const SDL_Color color)
+{
+	const int base = int(vertices.size());
+
+	vertices.push_back(SDL_Vertex{ SDL_FPoint{ x,     y     }, color, SDL_FPoint{ u0, v0 } });
+	vertices.push_back(SDL_Vertex{ SDL_FPoint{ x + w, y     }, color, SDL_FPoint{ u1, v0 } });
+	vertices.push_back(SDL_Vertex{ SDL_FPoint{ x + w, y + h }, color, SDL_FPoint{ u1, v1 } });
+	vertices.push_back(SDL_Vertex{ SDL_FPoint{ x,     y + h }, color, SDL_FPoint{ u0, v1 } });
+
+	indices.push_back(base + 0);
+	indices.push_back(base + 1);
+	indices.push_back(base + 2);
+	indices.push_back(base + 2);
+	indices.push_back(base + 3);
+	indices.push_back(base + 0);
+}
+
+void GeometryBatch::AddCircle(const float x, const float y, const float radius, int segments, const SDL_Color color)
+{
+	segments = std::max(int(MinCircleSegments), std::min(segments, int(MaxCircleSegments)));
+
+	const SDL_FPoint* rim = UnitCircle(segments);
+	const int base = int(vertices.size());
+
+	vertices.push_back(SDL_Vertex{ SDL_FPoint{ x, y }, color, SDL_FPoint{ 0, 0 } });
+
+	for (int I = 0; I < segments; I++)
+		vertices.push_back(SDL_Vertex{ SDL_FPoint{ x + radius * rim[I].x, y + radius * rim[I].y }, color, SDL_FPoint{ 0, 0 } });
+
+	for (int I = 0; I < segments; I++)
+	{
+		indices.push_back(base);
+		indices.push_back(base + 1 + I);
+		indices.push_back(base + 1 + (I + 1) % segments);
+	}
+}
+
+uint64_t GeometrySubmitCount()
+{
+	return submitCount;
+}
+
+void GeometryBatch::Flush(SDL_Renderer* renderer, SDL_Texture* texture)
+{
+	if (indices.size())
+	{
+		SDL_RenderGeometry(renderer, texture, vertices.data(), int(vertices.size()), indices.data(), int(indices.size()));
+		submitCount++;
+	}
+
+	Clear();
+}
+
+void GeometryBatch::Clear()
+{
+	vertices.clear();
+	indices.clear();
+}
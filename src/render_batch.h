@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "arena.h"
+
+enum {
+	MinCircleSegments = 3,
+	MaxCircleSegments = 64
+};
+
+// Points on the unit circle for the given segment count, precomputed at
+// startup. Returns segments + 1 points so the last edge closes the ring.
+const SDL_FPoint* UnitCircle(int segments);
+
+// SDL_RenderGeometry calls made by every GeometryBatch so far.
+uint64_t GeometrySubmitCount();
+
+// Collects coloured geometry into one vertex/index buffer and submits all of
+// it with a single SDL_RenderGeometry call. Without an arena the buffer lives
+// on the heap and is kept between frames; with one, the batch is meant to be
+// built, flushed and dropped within the frame.
+class GeometryBatch
+{
+public:
+	explicit GeometryBatch(FrameArena* arena = nullptr);
+
+	void Reserve(const size_t quads);
+
+	// x, y is the top left corner.
+	void AddRect(const float x, const float y, const float w, const float h, const SDL_Color color);
+
+	// u0, v0 and u1, v1 are the normalized texture coordinates of the corners.
+	void AddTexturedRect(const float x, const float y, const float w, const float h,
+	                     const float u0, const float v0, const float u1, const float v1, const SDL_Color color);
+
+	// Indexed triangle fan: one centre vertex plus one per segment.
+	void AddCircle(const float x, const float y, const float radius, int segments, const SDL_Color color);
+
+	// Draws everything added since the last flush and empties the batch,
+	// keeping its storage.
+	void Flush(SDL_Renderer* renderer, SDL_Texture* texture = nullptr);
+
+	// Empties the batch without drawing it.
+	void Clear();
+
+	size_t VertexCount() const { return vertices.size(); }
+
+private:
+	std::vector<SDL_Vertex, ArenaAllocator<SDL_Vertex>>	vertices;
+	std::vector<int, ArenaAllocator<int>>				indices;
+};
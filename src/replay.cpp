@@ -0,0 +1,186 @@
+#include "replay.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	uint32_t Fnv1a(uint32_t hash, const void* data, const size_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+
+		for (size_t I = 0; I < size; I++)
+			hash = (hash ^ bytes[I]) * 16777619u;
+
+		return hash;
+	}
+}
+
+uint32_t WorldChecksum(const WorldState& world)
+{
+	const BallPool&		balls	= world.balls;
+	const BlockField&	blocks	= world.blocks;
+
+	uint32_t hash = 2166136261u;
+
+	hash = Fnv1a(hash, &world.tick, sizeof(world.tick));
+	hash = Fnv1a(hash, &world.paddle.x, sizeof(world.paddle.x));
+
+	hash = Fnv1a(hash, &balls.count, sizeof(balls.count));
+	hash = Fnv1a(hash, balls.x.data(), sizeof(float) * balls.count);
+	hash = Fnv1a(hash, balls.y.data(), sizeof(float) * balls.count);
+	hash = Fnv1a(hash, balls.vx.data(), sizeof(float) * balls.count);
+	hash = Fnv1a(hash, balls.vy.data(), sizeof(float) * balls.count);
+
+	hash = Fnv1a(hash, &blocks.aliveCount, sizeof(blocks.aliveCount));
+	hash = Fnv1a(hash, blocks.alive.data(), sizeof(uint32_t) * blocks.alive.size());
+	hash = Fnv1a(hash, blocks.hp.data(), sizeof(uint16_t) * blocks.hp.size());
+
+	// Left out of single player games so their checksums stay as they were.
+	if (world.versus)
+	{
+		hash = Fnv1a(hash, &world.topPaddle.x, sizeof(world.topPaddle.x));
+		hash = Fnv1a(hash, world.score, sizeof(world.score));
+	}
+
+	return hash;
+}
+
+void Replay::Start(BreakoutSim& sim) const
+{
+	switch (levelKind)
+	{
+		case ReplayLevelBuiltIn:
+			sim.Reset(ballCount);
+			break;
+		case ReplayLevelBlocks:
+			sim.Reset(levelBlocks.data(), uint32_t(levelBlocks.size()), ballCount);
+			break;
+		case ReplayLevelGenerated:
+		{
+			std::vector<LevelBlock> blocks;
+			GenerateLevel(levelGen, blocks);
+
+			sim.Reset(blocks.data(), uint32_t(blocks.size()), ballCount);
+			break;
+		}
+	}
+}
+
+void Replay::Record(const SimInput& input)
+{
+	if (runs.size() && runs.back().paddleAxis == input.paddleAxis && runs.back().ticks < UINT16_MAX)
+		runs.back().ticks++;
+	else
+		runs.push_back(InputRun{ input.paddleAxis, 1 });
+
+	tickCount++;
+}
+
+bool Replay::Write(const char* path) const
+{
+	ReplayHeader header;
+	memcpy(header.magic, "BKRP", 4);
+	header.version			= ReplayVersion;
+	header.tickDt			= tickDt;
+	header.ballCount		= ballCount;
+	header.fixedPoint		= BREAKOUT_FIXED_POINT;
+	header.levelKind		= levelKind;
+	header.genSeed			= levelGen.seed;
+	header.genPattern		= levelGen.pattern;
+	header.genBlockCount	= levelGen.blockCount;
+	header.genDensity		= levelGen.density;
+	header.levelBlockCount	= uint32_t(levelBlocks.size());
+	header.runCount			= uint32_t(runs.size());
+	header.tickCount		= tickCount;
+	header.finalChecksum	= finalChecksum;
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+	{
+		printf("failed to open %s\n", path);
+		return false;
+	}
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(levelBlocks.data(), sizeof(LevelBlock), levelBlocks.size(), file);
+	fwrite(runs.data(), sizeof(InputRun), runs.size(), file);
+	fclose(file);
+
+	return true;
+}
+
+bool Replay::Load(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<uint8_t> buffer(size_t(size > 0 ? size : 0));
+	const bool read = size > 0 && fread(buffer.data(), buffer.size(), 1, file) == 1;
+	fclose(file);
+
+	ReplayHeader header;
+	if (read && buffer.size() >= sizeof(header))
+		memcpy(&header, buffer.data(), sizeof(header));
+
+	const bool valid =
+		read && buffer.size() >= sizeof(header) &&
+		memcmp(header.magic, "BKRP", 4) == 0 &&
+		header.version == ReplayVersion &&
+		header.levelKind <= ReplayLevelGenerated &&
+		header.genPattern < PatternCount &&
+		buffer.size() == sizeof(header) + sizeof(LevelBlock) * size_t(header.levelBlockCount) + sizeof(InputRun) * size_t(header.runCount);
+
+	if (!valid)
+	{
+		printf("%s is not a valid replay\n", path);
+		return false;
+	}
+
+	if (header.fixedPoint != BREAKOUT_FIXED_POINT)
+	{
+		printf("%s was recorded with %s physics\n", path, header.fixedPoint ? "fixed-point" : "float");
+		return false;
+	}
+
+	const LevelBlock*	blocks		= (const LevelBlock*)(buffer.data() + sizeof(header));
+	const InputRun*		inputRuns	= (const InputRun*)(blocks + header.levelBlockCount);
+
+	tickDt				= header.tickDt;
+	ballCount			= header.ballCount;
+	levelKind			= ReplayLevelKind(header.levelKind);
+	levelGen.seed		= header.genSeed;
+	levelGen.pattern	= LevelPattern(header.genPattern);
+	levelGen.blockCount	= header.genBlockCount;
+	levelGen.density	= header.genDensity;
+	levelBlocks.assign(blocks, blocks + header.levelBlockCount);
+	runs.assign(inputRuns, inputRuns + header.runCount);
+	tickCount			= header.tickCount;
+	finalChecksum		= header.finalChecksum;
+
+	return true;
+}
+
+bool ReplayPlayer::Next(SimInput& input)
+{
+	while (run < replay.runs.size() && runTick >= replay.runs[run].ticks)
+	{
+		run++;
+		runTick = 0;
+	}
+
+	if (run == replay.runs.size())
+		return false;
+
+	input.paddleAxis = replay.runs[run].paddleAxis;
+
+	runTick++;
+	tick++;
+
+	return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "level.h"
+#include "level_gen.h"
+#include "sim.h"
+
+// Input recording and replay. The sim is deterministic, so the level, the
+// tick length and the input of every tick are enough to re-run a session
+// bit for bit. Inputs are run-length encoded since the stick sits still for
+// most of a game. A checksum of the world at the end of the recording lets
+// a replay confirm it really reproduced the session. Float and fixed-point
+// builds simulate differently, so a replay only plays on the kind of build
+// that recorded it.
+
+enum {
+	ReplayVersion = 2
+};
+
+enum ReplayLevelKind : uint32_t
+{
+	ReplayLevelBuiltIn,		// BreakoutSim::Reset's own level
+	ReplayLevelBlocks,		// Blocks stored in the recording
+	ReplayLevelGenerated	// Rebuilt from the generator parameters
+};
+
+struct InputRun
+{
+	int16_t		paddleAxis;
+	uint16_t	ticks;
+};
+
+struct ReplayHeader
+{
+	char		magic[4];		// "BKRP"
+	uint32_t	version;
+	float		tickDt;
+	uint32_t	ballCount;
+	uint32_t	fixedPoint;		// BREAKOUT_FIXED_POINT of the recording build
+
+	uint32_t	levelKind;		// ReplayLevelKind
+	uint32_t	genSeed;
+	uint32_t	genPattern;
+	uint32_t	genBlockCount;
+	float		genDensity;
+	uint32_t	levelBlockCount;	// LevelBlocks after the header, for ReplayLevelBlocks
+
+	uint32_t	runCount;			// InputRuns after the blocks
+	uint32_t	tickCount;
+	uint32_t	finalChecksum;		// WorldChecksum after the last tick
+};
+
+// FNV-1a over everything that affects gameplay. Particles are cosmetic and
+// left out.
+uint32_t WorldChecksum(const WorldState& world);
+
+// Everything needed to rebuild a session: how the world was reset, and the
+// input of each tick.
+struct Replay
+{
+	float					tickDt		= 1.0f / 60.0f;
+	uint32_t				ballCount	= 1;
+
+	ReplayLevelKind			levelKind	= ReplayLevelBuiltIn;
+	LevelGenParams			levelGen;
+	std::vector<LevelBlock>	levelBlocks;
+
+	std::vector<InputRun>	runs;
+	uint32_t				tickCount		= 0;
+	uint32_t				finalChecksum	= 0;
+
+	// Resets sim to the replay's starting state.
+	void Start(BreakoutSim& sim) const;
+
+	void Record(const SimInput& input);
+
+	bool Write(const char* path) const;
+	bool Load(const char* path);
+};
+
+// Reads a replay's inputs back one tick at a time.
+class ReplayPlayer
+{
+public:
+	explicit ReplayPlayer(const Replay& replay) : replay{ replay } {}
+
+	// Fills input for the next tick, or returns false at the end.
+	bool Next(SimInput& input);
+
+	uint32_t Tick() const { return tick; }
+
+private:
+	const Replay&	replay;
+
+	size_t			run			= 0;
+	uint32_t		runTick		= 0;
+	uint32_t		tick		= 0;
+};
@@ -0,0 +1,69 @@
+#include "scene.h"
+#include "render_batch.h"
+
+namespace
+{
+	// Blends positions from the previous sim tick with the current ones so
+	// rendering stays smooth when the render and tick rates differ.
+	float Lerp(const float a, const float b, const float t)
+	{
+		return a + (b - a) * t;
+	}
+}
+
+void DrawWorld(SDL_Renderer* renderer, const WorldState& world, const float alpha, const float tickDt, FrameArena& arena)
+{
+	SDL_SetRenderDrawColor(renderer, 0xF1, 0xD3, 0xB3, 0xff);
+	SDL_RenderClear(renderer);
+
+	const SDL_Color fallingColor	= { 0xC7, 0xBC, 0xA1, 255 };
+	const SDL_Color shardColor		= { 0xA4, 0x97, 0x8E, 255 };
+	const SDL_Color ballColor		= { 0x65, 0x64, 0x7c, 255 };
+	const SDL_Color paddleColor		= { 0x61, 0x76, 0x4b, 255 };
+
+	const BlockField&	blocks		= world.blocks;
+	const ParticlePool&	particles	= world.particles;
+	const BallPool&		balls		= world.balls;
+
+	// Sized for this frame's scene, so the arena hands it out in one
+	// piece. A 16 segment circle takes about as much space as 8 quads.
+	GeometryBatch batch(&arena);
+	batch.Reserve(blocks.aliveCount + particles.count + balls.count * 8 + 2);
+
+	for (uint32_t I = 0; I < blocks.count; I++)
+	{
+		if (!blocks.IsAlive(I))
+			continue;
+
+		const uint32_t	rgba		= blocks.color[I];
+		const SDL_Color	blockColor	= { Uint8(rgba >> 24), Uint8(rgba >> 16), Uint8(rgba >> 8), Uint8(rgba) };
+
+		batch.AddRect(blocks.x[I] - blocks.halfW[I], blocks.y[I] - blocks.halfH[I], blocks.halfW[I] * 2.0f, blocks.halfH[I] * 2.0f, blockColor);
+	}
+
+	for (uint32_t I = 0; I < particles.count; I++)
+	{
+		// Step back along the velocity rather than keep previous positions.
+		const float back	= tickDt * (1.0f - alpha);
+		const float x		= particles.x[I] - particles.vx[I] * back;
+		const float y		= particles.y[I] - particles.vy[I] * back;
+
+		batch.AddRect(x - particles.halfW[I], y - particles.halfH[I], particles.halfW[I] * 2.0f, particles.halfH[I] * 2.0f,
+			particles.kind[I] == ParticleShard ? shardColor : fallingColor);
+	}
+
+	for (uint32_t I = 0; I < balls.count; I++)
+	{
+		batch.AddCircle(
+			Lerp(balls.prevX[I], balls.x[I], alpha),
+			Lerp(balls.prevY[I], balls.y[I], alpha),
+			balls.r[I], 16, ballColor);
+	}
+
+	batch.AddRect(Lerp(world.paddle.prevX, world.paddle.x, alpha), world.paddle.y, world.paddle.w, world.paddle.h, paddleColor);
+
+	if (world.versus)
+		batch.AddRect(Lerp(world.topPaddle.prevX, world.topPaddle.x, alpha), world.topPaddle.y, world.topPaddle.w, world.topPaddle.h, paddleColor);
+
+	batch.Flush(renderer);
+}
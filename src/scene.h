@@ -0,0 +1,11 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include "arena.h"
+#include "sim.h"
+
+// Draws the world as one geometry batch built in arena, blending the last
+// two ticks by alpha. Shared by the game and the benchmarks, so both measure
+// the same frame path.
+void DrawWorld(SDL_Renderer* renderer, const WorldState& world, const float alpha, const float tickDt, FrameArena& arena);
@@ -0,0 +1,680 @@
+#include "sim.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const float paddleWidth		= 100.0f;
+	const float paddleHeight	= 50.0f;
+	const float paddleMoveRate	= 1875.0f;	// Pixels per second at full stick deflection
+	const float paddleGap		= 50.0f;	// Between a paddle and its edge of the screen
+
+	const float ballRadius		= 50.0f;
+	const float ballWallMargin	= 25.0f;
+	const float ballStartSpeed	= 187.5f;	// Pixels per second on each axis
+	const float ballHitSpeedup	= 1.05f;
+	const float ballMaxSpeed	= 1500.0f;	// Per axis; hits stop speeding up a ball past this
+
+	const float		particleGravity	= 588.0f;	// Pixels per second squared, the old 9.8 / 60 per tick at 60 Hz
+	const uint32_t	shardsPerBlock	= 8;
+
+	const uint32_t	multiBallRelease	= 2;		// Extra balls from a multi-ball block
+	const float		multiBallSpread		= 0.5f;		// Radians between released balls
+
+	// Contacts resolved per ball per tick. Motion left over after the last
+	// one is dropped rather than risk tunnelling.
+	const int	maxContactIterations	= 8;
+	const float	simultaneousContact		= 1e-4f;	// Contacts this close in time resolve together
+}
+
+void BuildBlockGrid(std::vector<LevelBlock>& blocks, BlockGrid& grid)
+{
+	float maxW = 1.0f;
+	float maxH = 1.0f;
+
+	for (auto& block : blocks)
+	{
+		maxW = std::max(maxW, block.w);
+		maxH = std::max(maxH, block.h);
+	}
+
+	grid.cellSize	= std::max(maxW, maxH);
+	grid.columns	= int(SCREEN_WIDTH / grid.cellSize) + 1;
+	grid.rows		= int(SCREEN_HEIGHT / grid.cellSize) + 1;
+	grid.padX		= maxW / 2.0f;
+	grid.padY		= maxH / 2.0f;
+
+	auto cellIndex = [&](const LevelBlock& block)
+	{
+		const int x = std::max(0, std::min(int(block.x / grid.cellSize), grid.columns - 1));
+		const int y = std::max(0, std::min(int(block.y / grid.cellSize), grid.rows - 1));
+
+		return uint32_t(y * grid.columns + x);
+	};
+
+	std::stable_sort(blocks.begin(), blocks.end(),
+		[&](const LevelBlock& a, const LevelBlock& b) { return cellIndex(a) < cellIndex(b); });
+
+	grid.cellStart.assign(grid.columns * grid.rows + 1, 0);
+
+	for (auto& block : blocks)
+		grid.cellStart[cellIndex(block) + 1]++;
+
+	for (size_t I = 1; I < grid.cellStart.size(); I++)
+		grid.cellStart[I] += grid.cellStart[I - 1];
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::Reset(const uint32_t ballCount)
+{
+	std::vector<LevelBlock> blocks;
+
+	const float		blockStepX	= SCREEN_WIDTH / 12;
+	const uint32_t	blockColor	= 0x8B7E74FF;
+
+	for(size_t I = 0; I < 10; I++)
+		blocks.push_back(LevelBlock{ blockStepX + blockStepX * I, 50, blockStepX - 10, 50, 1, BlockNormal, 0, blockColor });
+	
+	for(size_t I = 0; I < 9; I++)
+		blocks.push_back(LevelBlock{ blockStepX * 1.5f + blockStepX * I, 110, blockStepX - 10, 50, 1, BlockNormal, 0, blockColor });
+
+	for(size_t I = 0; I < 10; I++)
+		blocks.push_back(LevelBlock{ blockStepX + blockStepX * I, 170, blockStepX - 10, 50, 1, BlockNormal, 0, blockColor });
+
+	Reset(blocks.data(), uint32_t(blocks.size()), ballCount);
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::Reset(const LevelBlock* levelBlocks, const uint32_t blockCount, const uint32_t ballCount)
+{
+	using S = TY_SCALAR;
+
+	PaddleT<S>&		paddle		= PhysicsPaddle();
+	PaddleT<S>&		topPaddle	= PhysicsTopPaddle();
+	BallPoolT<S>&	balls		= PhysicsBalls();
+
+	world.tick		= 0;
+	world.versus	= false;
+	world.score[0]	= 0;
+	world.score[1]	= 0;
+
+	paddle = { S(0.5f * SCREEN_WIDTH - paddleWidth / 2), S(SCREEN_HEIGHT - paddleGap - paddleHeight), S(paddleWidth), S(paddleHeight) };
+	paddle.prevX = paddle.x;
+
+	topPaddle	= paddle;
+	topPaddle.y	= S(paddleGap);
+
+	balls.count = 0;
+	balls.Spawn(BallT<S>{ S(float(SCREEN_WIDTH) / 2.0f), S(float(SCREEN_HEIGHT) / 2.0f), S(ballStartSpeed), S(ballStartSpeed), S(ballRadius) });
+
+	// Extra balls head downwards at angles between 20 and 160 degrees,
+	// spread by the golden ratio so any count covers the range evenly.
+	const S speed = S(ballStartSpeed) * Sqrt(S(2.0f));
+
+	for (uint32_t I = 1; I < ballCount; I++)
+	{
+		const S spread	= S(float(I)) * S(0.6180339887f);
+		const S angle	= (S(20.0f) + S(140.0f) * (spread - Floor(spread))) * S(3.14159265f) / S(180.0f);
+
+		if (!balls.Spawn(BallT<S>{ S(float(SCREEN_WIDTH) / 2.0f), S(float(SCREEN_HEIGHT) / 2.0f), speed * Cos(angle), speed * Sin(angle), S(ballRadius) }))
+			break;
+	}
+
+	world.particles.count	= 0;
+	world.particles.seed	= ParticleSeed;
+
+	// The grid wants blocks sorted by cell, so sort a copy of the level's.
+	std::vector<LevelBlock> blocks(levelBlocks, levelBlocks + blockCount);
+
+	BuildBlockGrid(blocks, world.grid);
+	world.blocks.Assign(blocks);
+
+	if constexpr (!FloatPhysics)
+	{
+		physicsBlocks.resize(world.blocks.count);
+
+		for (uint32_t I = 0; I < world.blocks.count; I++)
+		{
+			const Rect rect = world.blocks.GetRect(I);
+			physicsBlocks[I] = RectT<S>{ S(rect.x), S(rect.y), S(rect.w), S(rect.h) };
+		}
+	}
+
+	// Scratch for SweepBall, sized for the worst case so ticks never allocate.
+	overlaps.resize(world.blocks.count);
+	hits.reserve(world.blocks.count);
+
+	Publish();
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::ResetVersus()
+{
+	std::vector<LevelBlock> blocks;
+
+	const float		blockStepX	= SCREEN_WIDTH / 12;
+	const uint32_t	blockColor	= 0x8B7E74FF;
+
+	// Two rows clear of the serve in the centre of the screen.
+	for (const float y : { SCREEN_HEIGHT / 2 - 92.0f, SCREEN_HEIGHT / 2 + 92.0f })
+		for(size_t I = 0; I < 10; I++)
+			blocks.push_back(LevelBlock{ blockStepX + blockStepX * I, y, blockStepX - 10, 50, 1, BlockNormal, 0, blockColor });
+
+	Reset(blocks.data(), uint32_t(blocks.size()));
+
+	world.versus = true;
+}
+
+template<typename TY_SCALAR>
+PaddleT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsPaddle()
+{
+	if constexpr (FloatPhysics)
+		return world.paddle;
+	else
+		return physicsPaddle;
+}
+
+template<typename TY_SCALAR>
+PaddleT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsTopPaddle()
+{
+	if constexpr (FloatPhysics)
+		return world.topPaddle;
+	else
+		return physicsTopPaddle;
+}
+
+template<typename TY_SCALAR>
+BallPoolT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsBalls()
+{
+	if constexpr (FloatPhysics)
+		return world.balls;
+	else
+		return physicsBalls;
+}
+
+template<typename TY_SCALAR>
+const PaddleT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsPaddle() const
+{
+	if constexpr (FloatPhysics)
+		return world.paddle;
+	else
+		return physicsPaddle;
+}
+
+template<typename TY_SCALAR>
+const PaddleT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsTopPaddle() const
+{
+	if constexpr (FloatPhysics)
+		return world.topPaddle;
+	else
+		return physicsTopPaddle;
+}
+
+template<typename TY_SCALAR>
+const BallPoolT<TY_SCALAR>& BreakoutSimT<TY_SCALAR>::PhysicsBalls() const
+{
+	if constexpr (FloatPhysics)
+		return world.balls;
+	else
+		return physicsBalls;
+}
+
+template<typename TY_SCALAR>
+RectT<TY_SCALAR> BreakoutSimT<TY_SCALAR>::BlockRect(const uint32_t index) const
+{
+	if constexpr (FloatPhysics)
+		return world.blocks.GetRect(index);
+	else
+		return physicsBlocks[index];
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::Publish()
+{
+	if constexpr (!FloatPhysics)
+	{
+		const BallPoolT<TY_SCALAR>& balls = physicsBalls;
+
+		auto publishPaddle = [](const PaddleT<TY_SCALAR>& paddle)
+		{
+			return Paddle{ ToFloat(paddle.x), ToFloat(paddle.y), ToFloat(paddle.w), ToFloat(paddle.h), ToFloat(paddle.prevX) };
+		};
+
+		world.paddle	= publishPaddle(physicsPaddle);
+		world.topPaddle	= publishPaddle(physicsTopPaddle);
+
+		world.balls.count = balls.count;
+
+		for (uint32_t I = 0; I < balls.count; I++)
+		{
+			world.balls.x[I]		= ToFloat(balls.x[I]);
+			world.balls.y[I]		= ToFloat(balls.y[I]);
+			world.balls.vx[I]		= ToFloat(balls.vx[I]);
+			world.balls.vy[I]		= ToFloat(balls.vy[I]);
+			world.balls.r[I]		= ToFloat(balls.r[I]);
+			world.balls.prevX[I]	= ToFloat(balls.prevX[I]);
+			world.balls.prevY[I]	= ToFloat(balls.prevY[I]);
+		}
+	}
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::SweepBall(const uint32_t index, const TY_SCALAR dt)
+{
+	using S = TY_SCALAR;
+
+	BallPoolT<S>&		balls	= PhysicsBalls();
+	BlockField&			blocks	= world.blocks;
+
+	BallT<S> ball = balls.Get(index);
+
+	auto paddleRect = [](const PaddleT<S>& paddle)
+	{
+		return RectT<S>{ paddle.x + paddle.w / S(2.0f), paddle.y + paddle.h / S(2.0f), paddle.w, paddle.h };
+	};
+
+	const RectT<S> bottomRect	= paddleRect(PhysicsPaddle());
+	const RectT<S> topRect		= paddleRect(PhysicsTopPaddle());
+
+	S remaining = S(1.0f); // Fraction of this tick's motion still to cover
+
+	for (int iteration = 0; iteration < maxContactIterations && remaining > S(0.0f); iteration++)
+	{
+		const S dx = ball.vx * dt * remaining;
+		const S dy = ball.vy * dt * remaining;
+
+		const CircleT<S> ballCircle = { ball.x, ball.y, ball.r };
+
+		enum { None, WallX, WallY, PaddleHit, BlockHits } contact = None;
+		S firstTime = S(1.0f);
+
+		// Walls, for the centre against the wall margins.
+		auto wall = [&](const S position, const S delta, const S bound, const bool towards, const bool xAxis)
+		{
+			if (!towards)
+				return;
+
+			const S t = Abs(delta) > S(0.0f) ? std::max((bound - position) / delta, S(0.0f)) : S(0.0f);
+
+			if (t <= firstTime)
+			{
+				firstTime	= t;
+				contact		= xAxis ? WallX : WallY;
+			}
+		};
+
+		const S minWall = S(ballWallMargin);
+		const S maxWall = S(SCREEN_WIDTH - ballWallMargin);
+
+		wall(ball.x, dx, minWall, dx < S(0.0f) && ball.x + dx < minWall, true);
+		wall(ball.x, dx, maxWall, dx > S(0.0f) && ball.x + dx > maxWall, true);
+
+		// In versus games the top is player 2's goal, not a wall.
+		if (!world.versus)
+			wall(ball.y, dy, minWall, dy < S(0.0f) && ball.y + dy < minWall, false);
+
+		// A paddle only bounces a ball that is heading towards its goal.
+		S t, nx, ny;
+
+		if (ball.vy > S(0.0f) && SweptCircleRect(bottomRect, ballCircle, dx, dy, t, nx, ny) && t <= firstTime)
+		{
+			firstTime	= t;
+			contact		= PaddleHit;
+		}
+
+		if (world.versus && ball.vy < S(0.0f) && SweptCircleRect(topRect, ballCircle, dx, dy, t, nx, ny) && t <= firstTime)
+		{
+			firstTime	= t;
+			contact		= PaddleHit;
+		}
+
+		// Blocks: the kernel culls with the circle bounding the whole sweep,
+		// then each survivor gets the exact swept test. The cull runs in
+		// float either way; fixed point pads it by a pixel so rounding
+		// cannot drop a block the exact test would hit.
+		const S sweepLength = Length(dx, dy);
+		const Circle sweepBounds = {
+			ToFloat(ball.x + dx / S(2.0f)),
+			ToFloat(ball.y + dy / S(2.0f)),
+			ToFloat(ball.r + sweepLength / S(2.0f)) + (FloatPhysics ? 0.0f : 1.0f) };
+
+		hits.clear();
+
+		QueryBlockGrid(world.grid, 
+			sweepBounds.x - sweepBounds.r, sweepBounds.y - sweepBounds.r, 
+			sweepBounds.x + sweepBounds.r, sweepBounds.y + sweepBounds.r,
+			[&](const uint32_t begin, const uint32_t end)
+			{
+				const uint32_t count = CircleBlockOverlaps(blocks, begin, end, sweepBounds, overlaps.data());
+
+				for (uint32_t I = 0; I < count; I++)
+				{
+					BlockHitT<S> hit;
+
+					if (SweptCircleRect(BlockRect(overlaps[I]), ballCircle, dx, dy, hit.time, hit.normalX, hit.normalY))
+					{
+						hit.index		= overlaps[I];
+						hit.penetration	= S(0.0f);
+						hits.push_back(hit);
+					}
+				}
+			});
+
+		S firstBlockTime = S(1.0f);
+		for (const BlockHitT<S>& hit : hits)
+			firstBlockTime = std::min(firstBlockTime, hit.time);
+
+		if (hits.size() && firstBlockTime <= firstTime)
+		{
+			firstTime	= firstBlockTime;
+			contact		= BlockHits;
+		}
+
+		// Advance to the first contact.
+		ball.x += dx * firstTime;
+		ball.y += dy * firstTime;
+
+		if (contact == None)
+			break;
+
+		remaining *= S(1.0f) - firstTime;
+
+		switch (contact)
+		{
+			case WallX:
+				ball.vx = -ball.vx;
+				break;
+			case WallY:
+				ball.vy = -ball.vy;
+				break;
+			case PaddleHit:
+				ball.vy = -ball.vy;
+				break;
+			case BlockHits:
+			{
+				// Resolve every block touched at the first contact time and
+				// bounce off the combined normal's dominant axis, unless the
+				// ball is already moving away from it.
+				S normalX = S(0.0f);
+				S normalY = S(0.0f);
+
+				uint32_t releasedBalls = 0;
+
+				for (const BlockHitT<S>& hit : hits)
+				{
+					if (hit.time > firstTime + S(simultaneousContact))
+						continue;
+
+					if (blocks.hp[hit.index] > 1)
+						blocks.hp[hit.index]--;
+					else
+					{
+						EmitBlockBreak(world.particles, blocks.GetRect(hit.index), shardsPerBlock);
+
+						if (blocks.type[hit.index] == BlockMultiBall)
+							releasedBalls += multiBallRelease;
+
+						blocks.Kill(hit.index);
+					}
+
+					if (Abs(ball.vx) < S(ballMaxSpeed) && Abs(ball.vy) < S(ballMaxSpeed))
+					{
+						ball.vx *= S(ballHitSpeedup);
+						ball.vy *= S(ballHitSpeedup);
+					}
+
+					normalX += hit.normalX;
+					normalY += hit.normalY;
+				}
+
+				if (Abs(normalX) > Abs(normalY))
+				{
+					if (ball.vx * normalX < S(0.0f))
+						ball.vx = -ball.vx;
+				}
+				else if (ball.vy * normalY < S(0.0f))
+					ball.vy = -ball.vy;
+
+				// Released balls leave from the contact point, fanned either
+				// side of the bounce direction.
+				for (uint32_t I = 0; I < releasedBalls; I++)
+				{
+					const S angle	= S(multiBallSpread) * S(float(I / 2 + 1)) * (I & 1 ? S(-1.0f) : S(1.0f));
+					const S c		= Cos(angle);
+					const S s		= Sin(angle);
+
+					balls.Spawn(BallT<S>{ ball.x, ball.y, ball.vx * c - ball.vy * s, ball.vx * s + ball.vy * c, ball.r });
+				}
+				break;
+			}
+			case None:
+				break;
+		}
+	}
+
+	balls.Set(index, ball);
+}
+
+template<typename TY_SCALAR>
+SimStatus BreakoutSimT<TY_SCALAR>::Step(const SimInput& input, const float dt)
+{
+	using S = TY_SCALAR;
+
+	PaddleT<S>&		paddle		= PhysicsPaddle();
+	PaddleT<S>&		topPaddle	= PhysicsTopPaddle();
+	BallPoolT<S>&	balls		= PhysicsBalls();
+
+	auto& particles		= world.particles;
+
+	const S tickDt = S(dt);
+
+	world.tick++;
+
+	{
+		PROFILE_ZONE(ZonePhysics);
+
+		std::copy(balls.x.begin(), balls.x.begin() + balls.count, balls.prevX.begin());
+		std::copy(balls.y.begin(), balls.y.begin() + balls.count, balls.prevY.begin());
+
+		MovePaddle(paddle, input.paddleAxis, tickDt);
+
+		if (world.versus)
+			MovePaddle(topPaddle, input.topPaddleAxis, tickDt);
+
+		UpdateParticles(particles, particleGravity, dt);
+	}
+
+	{
+		PROFILE_ZONE(ZoneCollision);
+
+		// Walk backwards so a lost ball can be swapped out for one that has
+		// already moved this tick.
+		bool serveDown = false;
+
+		for (uint32_t I = balls.count; I-- > 0;)
+		{
+			SweepBall(I, tickDt);
+
+			const bool lostBottom	= balls.y[I] + S(ballWallMargin) > S(float(SCREEN_HEIGHT));
+			const bool lostTop		= world.versus && balls.y[I] - S(ballWallMargin) < S(0.0f);
+
+			if (lostBottom || lostTop)
+			{
+				if (world.versus)
+				{
+					world.score[lostBottom ? 1 : 0]++;
+					serveDown = lostBottom;
+				}
+
+				balls.Remove(I);
+			}
+		}
+
+		if (world.versus && !balls.count && Status() == SimStatus::Running)
+			Serve(serveDown);
+
+		Publish();
+
+		if (!balls.count)
+			return Status();
+	}
+
+	{
+		PROFILE_ZONE(ZoneCompaction);
+
+		RemoveParticlesBelow(particles, float(SCREEN_HEIGHT));
+	}
+
+	return Status();
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::MovePaddle(PaddleT<TY_SCALAR>& paddle, const int16_t axis, const TY_SCALAR dt)
+{
+	using S = TY_SCALAR;
+
+	paddle.prevX = paddle.x;
+
+	// 1 / 32768 rather than a divide: 32768 is out of 16.16 range.
+	const S x_relative = S(float(axis)) * S(1.0f / 32768.0f);
+	paddle.x += x_relative * S(paddleMoveRate) * dt;
+
+	paddle.x = std::max(S(0.0f), paddle.x);
+	paddle.x = std::min(S(float(SCREEN_WIDTH)) - paddle.w, paddle.x);
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::Serve(const bool down)
+{
+	using S = TY_SCALAR;
+
+	const S vy = down ? S(ballStartSpeed) : -S(ballStartSpeed);
+
+	PhysicsBalls().Spawn(BallT<S>{ S(float(SCREEN_WIDTH) / 2.0f), S(float(SCREEN_HEIGHT) / 2.0f), S(ballStartSpeed), vy, S(ballRadius) });
+}
+
+template<typename TY_SCALAR>
+size_t BreakoutSimT<TY_SCALAR>::SnapshotSize() const
+{
+	const BlockField&	blocks		= world.blocks;
+	const uint32_t		ballCount	= PhysicsBalls().count;
+	const uint32_t		particles	= world.particles.count;
+
+	return
+		sizeof(SimSnapshotHeader<TY_SCALAR>) +
+		sizeof(uint32_t) * blocks.alive.size() + sizeof(uint16_t) * blocks.count +
+		sizeof(TY_SCALAR) * 7 * ballCount +
+		(sizeof(float) * 6 + sizeof(uint8_t)) * particles;
+}
+
+template<typename TY_SCALAR>
+void BreakoutSimT<TY_SCALAR>::Save(uint8_t* snapshot) const
+{
+	const BlockField&				blocks		= world.blocks;
+	const BallPoolT<TY_SCALAR>&		balls		= PhysicsBalls();
+	const ParticlePool&				particles	= world.particles;
+
+	SimSnapshotHeader<TY_SCALAR> header;
+	header.tick				= world.tick;
+	header.blockCount		= blocks.count;
+	header.aliveCount		= blocks.aliveCount;
+	header.ballCount		= balls.count;
+	header.particleCount	= particles.count;
+	header.particleSeed		= particles.seed;
+	header.score[0]			= world.score[0];
+	header.score[1]			= world.score[1];
+	header.paddle			= PhysicsPaddle();
+	header.topPaddle		= PhysicsTopPaddle();
+
+	auto write = [&](const auto& source, const size_t count)
+	{
+		const size_t size = sizeof(source[0]) * count;
+
+		memcpy(snapshot, source.data(), size);
+		snapshot += size;
+	};
+
+	memcpy(snapshot, &header, sizeof(header));
+	snapshot += sizeof(header);
+
+	write(blocks.alive, blocks.alive.size());
+	write(blocks.hp, blocks.count);
+
+	for (auto* array : { &balls.x, &balls.y, &balls.vx, &balls.vy, &balls.r, &balls.prevX, &balls.prevY })
+		write(*array, balls.count);
+
+	for (auto* array : { &particles.x, &particles.y, &particles.vx, &particles.vy, &particles.halfW, &particles.halfH })
+		write(*array, particles.count);
+
+	write(particles.kind, particles.count);
+}
+
+template<typename TY_SCALAR>
+bool BreakoutSimT<TY_SCALAR>::Restore(const uint8_t* snapshot)
+{
+	BlockField&				blocks		= world.blocks;
+	BallPoolT<TY_SCALAR>&	balls		= PhysicsBalls();
+	ParticlePool&			particles	= world.particles;
+
+	SimSnapshotHeader<TY_SCALAR> header;
+	memcpy(&header, snapshot, sizeof(header));
+	snapshot += sizeof(header);
+
+	if (header.blockCount != blocks.count)
+		return false;
+
+	auto read = [&](auto& destination, const size_t count)
+	{
+		const size_t size = sizeof(destination[0]) * count;
+
+		memcpy(destination.data(), snapshot, size);
+		snapshot += size;
+	};
+
+	world.tick				= header.tick;
+	blocks.aliveCount		= header.aliveCount;
+	balls.count				= header.ballCount;
+	particles.count			= header.particleCount;
+	particles.seed			= header.particleSeed;
+	world.score[0]			= header.score[0];
+	world.score[1]			= header.score[1];
+	PhysicsPaddle()			= header.paddle;
+	PhysicsTopPaddle()		= header.topPaddle;
+
+	read(blocks.alive, blocks.alive.size());
+	read(blocks.hp, blocks.count);
+
+	for (auto* array : { &balls.x, &balls.y, &balls.vx, &balls.vy, &balls.r, &balls.prevX, &balls.prevY })
+		read(*array, balls.count);
+
+	for (auto* array : { &particles.x, &particles.y, &particles.vx, &particles.vy, &particles.halfW, &particles.halfH })
+		read(*array, particles.count);
+
+	read(particles.kind, particles.count);
+
+	Publish();
+	return true;
+}
+
+template<typename TY_SCALAR>
+SimStatus BreakoutSimT<TY_SCALAR>::Status() const
+{
+	if (world.versus)
+	{
+		if (world.score[0] >= VersusWinScore)
+			return SimStatus::Won;
+
+		return world.score[1] >= VersusWinScore ? SimStatus::Lost : SimStatus::Running;
+	}
+
+	if (!PhysicsBalls().count)
+		return SimStatus::Lost;
+
+	return world.blocks.aliveCount ? SimStatus::Running : SimStatus::Won;
+}
+
+template class BreakoutSimT<float>;
+template class BreakoutSimT<Fixed>;
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "block_field.h"
+#include "fixed.h"
+#include "geometry.h"
+#include "level.h"
+#include "particles.h"
+
+// Headless breakout simulation. Holds only plain data and does no rendering or
+// input, so it can be stepped offline for benchmarks and soak tests. The SDL
+// front end in main.cpp feeds it input and draws the resulting WorldState.
+
+//Screen dimension constants
+enum {
+	SCREEN_WIDTH  = 960,
+	SCREEN_HEIGHT = 544
+};
+
+struct SimInput
+{
+	int16_t paddleAxis		= 0;	// Raw left stick X, -32768..32767
+	int16_t topPaddleAxis	= 0;	// Player 2's stick, versus games only
+};
+
+enum {
+	VersusWinScore = 5
+};
+
+template<typename TY_SCALAR>
+struct PaddleT
+{
+	TY_SCALAR x;	// Left edge
+	TY_SCALAR y;	// Top edge
+	TY_SCALAR w;
+	TY_SCALAR h;
+
+	TY_SCALAR prevX;	// x before the last tick, for render interpolation
+};
+
+template<typename TY_SCALAR>
+struct BallT
+{
+	TY_SCALAR x;
+	TY_SCALAR y;
+	TY_SCALAR vx;
+	TY_SCALAR vy;
+	TY_SCALAR r;
+};
+
+enum {
+	MaxBalls = 4096
+};
+
+// Contiguous structure-of-arrays pool of balls. Storage for MaxBalls is
+// allocated once, and removing a ball moves the last ball into its slot.
+template<typename TY_SCALAR>
+struct BallPoolT
+{
+	uint32_t				count = 0;
+
+	std::vector<TY_SCALAR>	x;
+	std::vector<TY_SCALAR>	y;
+	std::vector<TY_SCALAR>	vx;
+	std::vector<TY_SCALAR>	vy;
+	std::vector<TY_SCALAR>	r;
+
+	// Position before the last tick, for render interpolation.
+	std::vector<TY_SCALAR>	prevX;
+	std::vector<TY_SCALAR>	prevY;
+
+	BallPoolT()
+		: x(MaxBalls), y(MaxBalls), vx(MaxBalls), vy(MaxBalls), r(MaxBalls), prevX(MaxBalls), prevY(MaxBalls)
+	{
+	}
+
+	bool Spawn(const BallT<TY_SCALAR>& ball)
+	{
+		if (count == MaxBalls)
+			return false;
+
+		Set(count, ball);
+		prevX[count] = ball.x;
+		prevY[count] = ball.y;
+		count++;
+
+		return true;
+	}
+
+	void Remove(const uint32_t index)
+	{
+		const uint32_t last = --count;
+
+		x[index]		= x[last];
+		y[index]		= y[last];
+		vx[index]		= vx[last];
+		vy[index]		= vy[last];
+		r[index]		= r[last];
+		prevX[index]	= prevX[last];
+		prevY[index]	= prevY[last];
+	}
+
+	BallT<TY_SCALAR> Get(const uint32_t index) const
+	{
+		return BallT<TY_SCALAR>{ x[index], y[index], vx[index], vy[index], r[index] };
+	}
+
+	void Set(const uint32_t index, const BallT<TY_SCALAR>& ball)
+	{
+		x[index]	= ball.x;
+		y[index]	= ball.y;
+		vx[index]	= ball.vx;
+		vy[index]	= ball.vy;
+		r[index]	= ball.r;
+	}
+};
+
+using Paddle	= PaddleT<float>;
+using Ball		= BallT<float>;
+using BallPool	= BallPoolT<float>;
+
+// Uniform grid over the blocks, built once when a level loads. Each block is
+// filed under the cell holding its centre and the blocks are sorted by cell,
+// so the cells of one grid row are a single contiguous range of blocks.
+// Queries are padded by the largest block half extents to catch blocks that
+// overlap from a neighbouring cell.
+struct BlockGrid
+{
+	float	cellSize;
+	int		columns;
+	int		rows;
+	float	padX;
+	float	padY;
+
+	std::vector<uint32_t> cellStart;	// columns * rows + 1 offsets into blocks
+};
+
+// Sorts blocks by cell and fills in grid.
+void BuildBlockGrid(std::vector<LevelBlock>& blocks, BlockGrid& grid);
+
+// Calls fn(begin, end) with the block index range of each grid row that may
+// contain blocks overlapping the box.
+template<typename FN>
+void QueryBlockGrid(const BlockGrid& grid, const float minX, const float minY, const float maxX, const float maxY, FN fn)
+{
+	if (grid.cellStart.size() < 2)
+		return;
+
+	auto cellX = [&](const float x) { return std::max(0, std::min(int(x / grid.cellSize), grid.columns - 1)); };
+	auto cellY = [&](const float y) { return std::max(0, std::min(int(y / grid.cellSize), grid.rows - 1)); };
+
+	const int x0 = cellX(minX - grid.padX);
+	const int x1 = cellX(maxX + grid.padX);
+	const int y0 = cellY(minY - grid.padY);
+	const int y1 = cellY(maxY + grid.padY);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		const uint32_t begin	= grid.cellStart[y * grid.columns + x0];
+		const uint32_t end		= grid.cellStart[y * grid.columns + x1 + 1];
+
+		if (begin != end)
+			fn(begin, end);
+	}
+}
+
+struct WorldState
+{
+	uint32_t	tick;
+
+	Paddle		paddle;
+	BallPool	balls;
+
+	// Versus games only: player 2's paddle at the top, and the points of
+	// player 1 (bottom) and player 2.
+	bool		versus;
+	Paddle		topPaddle;
+	uint32_t	score[2];
+
+	BlockField					blocks;			// Sorted by grid cell, never reordered during play
+	BlockGrid					grid;
+
+	ParticlePool				particles;		// Falling blocks and shards, cosmetic only
+};
+
+enum class SimStatus
+{
+	Running,
+	Lost,
+	Won
+};
+
+// Fixed-size start of a sim snapshot, see BreakoutSimT::Save.
+template<typename TY_SCALAR>
+struct SimSnapshotHeader
+{
+	uint32_t			tick;
+	uint32_t			blockCount;		// Snapshots only restore into the level they came from
+	uint32_t			aliveCount;
+	uint32_t			ballCount;
+	uint32_t			particleCount;
+	uint32_t			particleSeed;
+	uint32_t			score[2];
+
+	PaddleT<TY_SCALAR>	paddle;
+	PaddleT<TY_SCALAR>	topPaddle;
+};
+
+// Empty stand-in for physics state the float sim keeps directly in its world.
+struct NoPhysicsState {};
+
+// The simulation, templated over the scalar type of its physics: float, or
+// Fixed for a deterministic integer-only path (see fixed.h) whose results are
+// bit-identical on every platform. Both are instantiated in sim.cpp.
+//
+// world is always the float view used by rendering, replays and benchmarks.
+// The fixed-point sim keeps its own paddles, balls and block bounds, and
+// copies them out to world after every Reset and Step.
+template<typename TY_SCALAR>
+class BreakoutSimT
+{
+public:
+	// Resets the world to the start of the built-in level, used when no
+	// level file is available.
+	void		Reset(const uint32_t ballCount = 1);
+
+	// Resets the world to the start of a level. Balls past the first are
+	// fanned out at different angles, for multi-ball stress scenes.
+	void		Reset(const LevelBlock* blocks, const uint32_t blockCount, const uint32_t ballCount = 1);
+
+	// Resets the world to a two player game. Player 2's paddle replaces the
+	// top wall and the blocks sit in two rows across the middle. A ball that
+	// gets past a paddle scores for the other player, and a new ball is
+	// served towards the player who conceded once none are left. Step
+	// reports Won when player 1 reaches VersusWinScore, Lost for player 2.
+	void		ResetVersus();
+
+	// Advances the world by dt seconds.
+	SimStatus	Step(const SimInput& input, const float dt);
+
+	// Snapshots hold everything Step can change and none of the level's
+	// static geometry: a SimSnapshotHeader, then the block alive bits and
+	// hp, and the live part of the ball and particle arrays. Saving and
+	// restoring are plain copies, cheap enough to do every tick.
+
+	// Bytes Save writes for the current state.
+	size_t		SnapshotSize() const;
+
+	void		Save(uint8_t* snapshot) const;
+
+	// Returns to a state saved from the current level, or returns false.
+	bool		Restore(const uint8_t* snapshot);
+
+	// Status as Step would report it for the current state.
+	SimStatus	Status() const;
+
+	WorldState	world;
+
+private:
+	static constexpr bool FloatPhysics = std::is_same<TY_SCALAR, float>::value;
+
+	template<typename TY>
+	using PhysicsState = std::conditional_t<FloatPhysics, NoPhysicsState, TY>;
+
+	PaddleT<TY_SCALAR>&				PhysicsPaddle();
+	PaddleT<TY_SCALAR>&				PhysicsTopPaddle();
+	BallPoolT<TY_SCALAR>&			PhysicsBalls();
+	const PaddleT<TY_SCALAR>&		PhysicsPaddle() const;
+	const PaddleT<TY_SCALAR>&		PhysicsTopPaddle() const;
+	const BallPoolT<TY_SCALAR>&		PhysicsBalls() const;
+	RectT<TY_SCALAR>				BlockRect(const uint32_t index) const;
+
+	// Copies the physics state out to world, a no-op for float physics.
+	void		Publish();
+
+	// Moves a paddle by one tick of stick input.
+	void		MovePaddle(PaddleT<TY_SCALAR>& paddle, const int16_t axis, const TY_SCALAR dt);
+
+	// Serves a new versus ball from the centre, towards the top or bottom.
+	void		Serve(const bool down);
+
+	// Moves one ball through a tick, stopping at each contact on the way.
+	void		SweepBall(const uint32_t index, const TY_SCALAR dt);
+
+	PhysicsState<PaddleT<TY_SCALAR>>				physicsPaddle;
+	PhysicsState<PaddleT<TY_SCALAR>>				physicsTopPaddle;
+	PhysicsState<BallPoolT<TY_SCALAR>>				physicsBalls;
+	PhysicsState<std::vector<RectT<TY_SCALAR>>>		physicsBlocks;	// Bounds of world.blocks, same order
+
+	// Scratch for the collision stage, reused every tick.
+	std::vector<uint32_t>				overlaps;
+	std::vector<BlockHitT<TY_SCALAR>>	hits;
+};
+
+using BreakoutSimFloat = BreakoutSimT<float>;
+using BreakoutSimFixed = BreakoutSimT<Fixed>;
+
+// The game's physics path, chosen at build time with BREAKOUT_FIXED_POINT.
+#ifndef BREAKOUT_FIXED_POINT
+#define BREAKOUT_FIXED_POINT 0
+#endif
+
+#if BREAKOUT_FIXED_POINT
+using BreakoutSim = BreakoutSimFixed;
+#else
+using BreakoutSim = BreakoutSimFloat;
+#endif
@@ -0,0 +1,110 @@
+#include "snapshot.h"
+
+SimHistory::SimHistory(BreakoutSim& sim, const size_t bytes)
+	: sim{ sim }, buffer(bytes), entries(MaxSnapshots), inputs(MaxSnapshots)
+{
+}
+
+void SimHistory::Clear()
+{
+	oldestTick	= sim.world.tick;
+	count		= 0;
+	writeOffset	= 0;
+
+	Save();
+}
+
+SimStatus SimHistory::Step(const SimInput& input, const float dt)
+{
+	const SimStatus status = sim.Step(input, dt);
+
+	inputs[sim.world.tick % MaxSnapshots] = input;
+	Save();
+
+	return status;
+}
+
+bool SimHistory::Restore(const uint32_t tick)
+{
+	if (!count || tick < OldestTick() || tick > NewestTick())
+		return false;
+
+	const Entry& entry = entries[tick % MaxSnapshots];
+
+	if (!sim.Restore(buffer.data() + entry.offset))
+		return false;
+
+	count		= tick - oldestTick + 1;
+	writeOffset	= entry.offset + entry.size;
+
+	return true;
+}
+
+bool SimHistory::Resimulate(const uint32_t tick, const SimInput& input, const float dt)
+{
+	const uint32_t newest = NewestTick();
+
+	if (!count || tick == 0 || tick > newest || !Restore(tick - 1))
+		return false;
+
+	inputs[tick % MaxSnapshots] = input;
+
+	// Restore only forgot the snapshots; the inputs of later ticks are
+	// still in place.
+	for (uint32_t I = tick; I <= newest && sim.Status() == SimStatus::Running; I++)
+		Step(inputs[I % MaxSnapshots], dt);
+
+	return true;
+}
+
+void SimHistory::DropOldest()
+{
+	oldestTick++;
+	count--;
+}
+
+void SimHistory::Save()
+{
+	const size_t size = (sim.SnapshotSize() + 15) & ~size_t(15);
+
+	if (size > buffer.size())
+	{
+		// Cannot hold even one tick of this state.
+		oldestTick	= sim.world.tick + 1;
+		count		= 0;
+		return;
+	}
+
+	size_t offset = writeOffset;
+
+	// Snapshots are contiguous: wrap to the start rather than split one,
+	// dropping the oldest ones left in the skipped tail.
+	if (offset + size > buffer.size())
+	{
+		while (count && entries[oldestTick % MaxSnapshots].offset >= offset)
+			DropOldest();
+
+		offset = 0;
+	}
+
+	// Drop the oldest snapshots until the new one no longer overlaps them.
+	while (count)
+	{
+		const Entry& oldest = entries[oldestTick % MaxSnapshots];
+
+		if (count < MaxSnapshots && (oldest.offset >= offset + size || oldest.offset + oldest.size <= offset))
+			break;
+
+		DropOldest();
+	}
+
+	if (!count)
+		oldestTick = sim.world.tick;
+
+	sim.Save(buffer.data() + offset);
+
+	entries[sim.world.tick % MaxSnapshots] = Entry{ offset, size };
+	count++;
+
+	writeOffset = offset + size;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sim.h"
+
+// A ring of per-tick sim snapshots, for rewinding in practice and for
+// rollback in networked play. Snapshots are packed one after another into a
+// buffer allocated once, each only as large as the state it holds, so a
+// simple level keeps far more history than a 100k block stress scene. The
+// oldest snapshots are overwritten first.
+
+enum {
+	SnapshotRingBytes	= 8 << 20,
+	MaxSnapshots		= 1024		// Ticks of history at most, about 17 s at 60 Hz
+};
+
+class SimHistory
+{
+public:
+	explicit SimHistory(BreakoutSim& sim, const size_t bytes = SnapshotRingBytes);
+
+	// Forgets all history and saves the sim's current state. Call after
+	// resetting the sim.
+	void		Clear();
+
+	// Steps the sim and saves the state it ends in.
+	SimStatus	Step(const SimInput& input, const float dt);
+
+	// Returns the sim to the end of tick and forgets the ticks after it.
+	// Returns false, leaving the sim alone, when tick is not held.
+	bool		Restore(const uint32_t tick);
+
+	// Replaces the input of a past tick and simulates forward again to the
+	// current tick with the inputs saved for the ones after it. Returns false
+	// when the tick before it is no longer held.
+	bool		Resimulate(const uint32_t tick, const SimInput& input, const float dt);
+
+	bool		Empty() const		{ return count == 0; }
+	uint32_t	OldestTick() const	{ return oldestTick; }
+	uint32_t	NewestTick() const	{ return oldestTick + count - 1; }
+
+	// Input that produced a held tick.
+	SimInput	Input(const uint32_t tick) const { return inputs[tick % MaxSnapshots]; }
+
+private:
+	struct Entry
+	{
+		size_t offset;
+		size_t size;
+	};
+
+	void		Save();
+	void		DropOldest();
+
+	BreakoutSim&			sim;
+
+	std::vector<uint8_t>	buffer;
+	std::vector<Entry>		entries;	// Indexed by tick % MaxSnapshots
+	std::vector<SimInput>	inputs;		// Indexed by tick % MaxSnapshots
+
+	uint32_t				oldestTick	= 0;
+	uint32_t				count		= 0;
+	size_t					writeOffset	= 0;
+};
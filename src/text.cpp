@@ -0,0 +1,172 @@
+#include "text.h"
+#include "profiler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	const FontGlyph* FindGlyph(const FontAsset& font, const char c)
+	{
+		const int index = int((unsigned char)c) - FontFirstChar;
+
+		if (index < 0 || index >= FontCharCount)
+			return nullptr;
+
+		return &font.glyphs[index];
+	}
+
+	// White texels carrying coverage in alpha, so vertex colours tint the text.
+	SDL_Texture* CreateAtlasTexture(SDL_Renderer* renderer, const uint8_t* alpha, const int width, const int height)
+	{
+		Uint32* pixels = (Uint32*)malloc(sizeof(Uint32) * width * height);
+		ExpandFontAtlas(alpha, width * height, pixels);
+
+		SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, width, height);
+		SDL_UpdateTexture(texture, nullptr, pixels, width * 4);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+		free(pixels);
+		return texture;
+	}
+}
+
+bool LoadFont(SDL_Renderer* renderer, FontAsset& font, const char* path)
+{
+	PROFILE_ZONE(ZoneLoadFont);
+
+	long size;
+	unsigned char* fontBuffer;
+
+	FILE* fontFile = fopen(path, "rb");
+	if (!fontFile)
+	{
+		printf("failed to open %s\n", path);
+		return false;
+	}
+
+	fseek(fontFile, 0, SEEK_END);
+	size = ftell(fontFile); /* how long is the file ? */
+	fseek(fontFile, 0, SEEK_SET); /* reset */
+    
+	fontBuffer = (unsigned char*)malloc(size);
+
+	fread(fontBuffer, size, 1, fontFile);
+	fclose(fontFile);
+
+	FontAtlas atlas;
+	const bool built = BuildFontAtlas(fontBuffer, atlas);
+
+	free(fontBuffer);
+
+	if (!built)
+		return false;
+
+	font.atlas = CreateAtlasTexture(renderer, atlas.alpha.data(), atlas.width, atlas.height);
+
+	font.atlasWidth		= atlas.width;
+	font.atlasHeight	= atlas.height;
+	font.pixelHeight	= atlas.pixelHeight;
+	font.ascent			= atlas.ascent;
+
+	for (int I = 0; I < FontCharCount; I++)
+		font.glyphs[I] = atlas.glyphs[I];
+
+	return true;
+}
+
+bool LoadBakedFont(SDL_Renderer* renderer, FontAsset& font, const char* path)
+{
+	PROFILE_ZONE(ZoneLoadFont);
+
+	FILE* fontFile = fopen(path, "rb");
+	if (!fontFile)
+		return false;
+
+	fseek(fontFile, 0, SEEK_END);
+	const long size = ftell(fontFile);
+	fseek(fontFile, 0, SEEK_SET);
+
+	unsigned char* buffer = (unsigned char*)malloc(size);
+	const bool read = fread(buffer, size, 1, fontFile) == 1;
+	fclose(fontFile);
+
+	const BakedFontHeader* header = (const BakedFontHeader*)buffer;
+
+	const bool valid = 
+		read && size_t(size) >= sizeof(BakedFontHeader) &&
+		memcmp(header->magic, "BKFN", 4) == 0 &&
+		header->version		== BakedFontVersion &&
+		header->firstChar	== FontFirstChar &&
+		header->charCount	== FontCharCount &&
+		size_t(size) == sizeof(BakedFontHeader) + sizeof(FontGlyph) * FontCharCount + size_t(header->width) * header->height;
+
+	if (!valid)
+	{
+		printf("%s is not a valid baked font\n", path);
+		free(buffer);
+		return false;
+	}
+
+	const FontGlyph*	glyphs	= (const FontGlyph*)(buffer + sizeof(BakedFontHeader));
+	const uint8_t*		alpha	= (const uint8_t*)(glyphs + FontCharCount);
+
+	font.atlas = CreateAtlasTexture(renderer, alpha, header->width, header->height);
+
+	font.atlasWidth		= header->width;
+	font.atlasHeight	= header->height;
+	font.pixelHeight	= header->pixelHeight;
+	font.ascent			= header->ascent;
+
+	memcpy(font.glyphs, glyphs, sizeof(font.glyphs));
+
+	free(buffer);
+	return true;
+}
+
+float MeasureText(const FontAsset& font, const char* text)
+{
+	float width = 0.0f;
+
+	for (; *text; text++)
+	{
+		if (const FontGlyph* glyph = FindGlyph(font, *text))
+			width += glyph->xadvance;
+	}
+
+	return width;
+}
+
+void AddText(GeometryBatch& batch, const FontAsset& font, float x, const float y, const float scale, const char* text, const SDL_Color color)
+{
+	const float baseline	= y + font.ascent * scale;
+	const float invW		= 1.0f / float(font.atlasWidth);
+	const float invH		= 1.0f / float(font.atlasHeight);
+
+	for (; *text; text++)
+	{
+		const FontGlyph* glyph = FindGlyph(font, *text);
+		if (!glyph)
+			continue;
+
+		if (glyph->x1 > glyph->x0)
+		{
+			batch.AddTexturedRect(
+				x + glyph->xoff * scale, baseline + glyph->yoff * scale,
+				(glyph->xoff2 - glyph->xoff) * scale, (glyph->yoff2 - glyph->yoff) * scale,
+				glyph->x0 * invW, glyph->y0 * invH, glyph->x1 * invW, glyph->y1 * invH,
+				color);
+		}
+
+		x += glyph->xadvance * scale;
+	}
+}
+
+void DrawText(SDL_Renderer* renderer, const FontAsset& font, const float x, const float y, const float scale, const char* text, const SDL_Color color)
+{
+	static GeometryBatch textBatch;
+
+	AddText(textBatch, font, x, y, scale, text, color);
+	textBatch.Flush(renderer, font.atlas);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include "font_atlas.h"
+#include "render_batch.h"
+
+// A font packed into one texture. Every glyph of a string is emitted into a
+// GeometryBatch, so a whole string (or a whole frame of text) is one draw call.
+struct FontAsset
+{
+	SDL_Texture*	atlas;
+	int				atlasWidth;
+	int				atlasHeight;
+	float			pixelHeight;
+	float			ascent;
+
+	FontGlyph		glyphs[FontCharCount];
+};
+
+// Rasterizes a TrueType font at load time.
+bool	LoadFont(SDL_Renderer* renderer, FontAsset& font, const char* path);
+
+// Loads an atlas baked by tools/fontbake.
+bool	LoadBakedFont(SDL_Renderer* renderer, FontAsset& font, const char* path);
+
+// Width of text in pixels at scale 1. Lines are font.pixelHeight tall.
+float	MeasureText(const FontAsset& font, const char* text);
+
+// x, y is the top left corner of the line.
+void	AddText(GeometryBatch& batch, const FontAsset& font, float x, const float y, const float scale, const char* text, const SDL_Color color);
+
+// AddText and submit straight away.
+void	DrawText(SDL_Renderer* renderer, const FontAsset& font, const float x, const float y, const float scale, const char* text, const SDL_Color color);
@@ -0,0 +1,83 @@
+#include "trace.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+std::atomic<bool> gTraceRecording{ false };
+
+namespace
+{
+	struct TraceEventRecord
+	{
+		Uint64	ticks;
+		Uint32	zone;
+		Uint32	phase;
+	};
+
+	TraceEventRecord*	events		= nullptr;
+	size_t				capacity	= 0;
+	Uint64				startTicks	= 0;
+
+	std::atomic<size_t>	eventCount{ 0 };
+}
+
+void TraceStart(const size_t requestedCapacity)
+{
+	if (capacity < requestedCapacity)
+	{
+		free(events);
+		events		= (TraceEventRecord*)malloc(sizeof(TraceEventRecord) * requestedCapacity);
+		capacity	= events ? requestedCapacity : 0;
+	}
+
+	eventCount.store(0, std::memory_order_relaxed);
+	startTicks = SDL_GetPerformanceCounter();
+
+	gTraceRecording.store(capacity != 0, std::memory_order_release);
+}
+
+void TraceStop()
+{
+	gTraceRecording.store(false, std::memory_order_release);
+}
+
+void TraceRecord(const int zone, const char phase, const Uint64 ticks)
+{
+	const size_t index = eventCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (index < capacity)
+		events[index] = TraceEventRecord{ ticks, Uint32(zone), Uint32(phase) };
+}
+
+bool TraceWrite(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		printf("failed to open %s\n", path);
+		return false;
+	}
+
+	const size_t count	= std::min(eventCount.load(std::memory_order_acquire), capacity);
+	const double toUs	= 1000000.0 / double(SDL_GetPerformanceFrequency());
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	for (size_t I = 0; I < count; I++)
+	{
+		const TraceEventRecord& event = events[I];
+
+		fprintf(file, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+			ProfilerZoneName(ProfileZoneId(event.zone)), char(event.phase),
+			double(event.ticks - startTicks) * toUs,
+			I + 1 < count ? "," : "");
+	}
+
+	fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(file);
+
+	printf("wrote %zu trace events to %s\n", count, path);
+	return true;
+}
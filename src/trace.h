@@ -0,0 +1,26 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+
+// Records profiler zone begin/end events into a buffer allocated when
+// recording starts, and writes them out as Chrome trace-event JSON that loads
+// in Perfetto or chrome://tracing. Recording an event is one atomic increment
+// and a store, and events past the end of the buffer are dropped.
+
+enum {
+	TraceDefaultCapacity = 1 << 18
+};
+
+extern std::atomic<bool> gTraceRecording;
+
+void	TraceStart(const size_t capacity = TraceDefaultCapacity);
+void	TraceStop();
+bool	TraceWrite(const char* path);
+
+void	TraceRecord(const int zone, const char phase, const Uint64 ticks);
+
+inline bool TraceIsRecording()
+{
+	return gTraceRecording.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,148 @@
+// Checks that every CircleBlockOverlaps variant compiled into this build
+// returns exactly the blocks the scalar kernel does, over random fields,
+// ranges and circles. Configure with -DBREAKOUT_HOST_AVX2=ON to cover the
+// AVX2 kernel as well; ARM hosts check the NEON one.
+//
+// usage: block_field_test [--seed S]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "block_field.h"
+
+namespace
+{
+	typedef uint32_t (*OverlapKernel)(const BlockField&, uint32_t, uint32_t, const Circle&, uint32_t*);
+
+	struct KernelVariant
+	{
+		const char*		name;
+		OverlapKernel	kernel;
+	};
+
+	const KernelVariant variants[] = {
+#if defined(__SSE2__)
+		{ "sse2", CircleBlockOverlapsSSE },
+#endif
+#if defined(__AVX2__)
+		{ "avx2", CircleBlockOverlapsAVX2 },
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		{ "neon", CircleBlockOverlapsNEON },
+#endif
+		{ "default", CircleBlockOverlaps },
+	};
+
+	const uint32_t fieldCount		= 200;
+	const uint32_t queriesPerField	= 200;
+
+	uint32_t NextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return state;
+	}
+
+	float RandomRange(uint32_t& state, const float min, const float max)
+	{
+		return min + (max - min) * float(NextRandom(state) & 0xFFFFFF) / float(0xFFFFFF);
+	}
+
+	// Blocks scattered over a small area so most circles touch several,
+	// with some killed so the live mask matters.
+	void FillField(uint32_t& state, BlockField& field)
+	{
+		std::vector<LevelBlock> blocks(1 + NextRandom(state) % 300);
+
+		for (LevelBlock& block : blocks)
+		{
+			block		= LevelBlock{};
+			block.x		= RandomRange(state, 0.0f, 400.0f);
+			block.y		= RandomRange(state, 0.0f, 300.0f);
+			block.w		= RandomRange(state, 1.0f, 80.0f);
+			block.h		= RandomRange(state, 1.0f, 40.0f);
+			block.hp	= 1;
+		}
+
+		field.Assign(blocks);
+
+		for (uint32_t I = 0; I < field.count; I++)
+		{
+			if (NextRandom(state) % 4 == 0)
+				field.Kill(I);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t seed = 1;
+
+	for (int I = 1; I + 1 < argc; I += 2)
+	{
+		if (strcmp(argv[I], "--seed") == 0)
+			seed = std::max(1u, uint32_t(strtoul(argv[I + 1], nullptr, 10)));
+	}
+
+	uint32_t state = seed;
+
+	BlockField				field;
+	std::vector<uint32_t>	expected;
+	std::vector<uint32_t>	actual;
+
+	uint64_t checks		= 0;
+	uint64_t overlaps	= 0;
+	uint32_t failures	= 0;
+
+	for (uint32_t F = 0; F < fieldCount; F++)
+	{
+		FillField(state, field);
+
+		expected.resize(field.count);
+		actual.resize(field.count);
+
+		for (uint32_t Q = 0; Q < queriesPerField; Q++)
+		{
+			// Odd ranges make the kernels finish on a partial vector.
+			uint32_t begin	= NextRandom(state) % (field.count + 1);
+			uint32_t end	= NextRandom(state) % (field.count + 1);
+			if (begin > end)
+				std::swap(begin, end);
+
+			const Circle circle = {
+				RandomRange(state, -50.0f, 450.0f),
+				RandomRange(state, -50.0f, 350.0f),
+				RandomRange(state, 0.0f, 120.0f) };
+
+			const uint32_t expectedCount = CircleBlockOverlapsScalar(field, begin, end, circle, expected.data());
+
+			for (const KernelVariant& variant : variants)
+			{
+				const uint32_t count = variant.kernel(field, begin, end, circle, actual.data());
+
+				checks++;
+
+				if (count == expectedCount && memcmp(actual.data(), expected.data(), count * sizeof(uint32_t)) == 0)
+					continue;
+
+				if (failures++ < 10)
+				{
+					printf("FAIL %s: field %u query %u range [%u, %u) circle (%g, %g, %g): %u overlaps, scalar found %u\n",
+						variant.name, F, Q, begin, end, circle.x, circle.y, circle.r, count, expectedCount);
+				}
+			}
+
+			overlaps += expectedCount;
+		}
+	}
+
+	printf("%llu checks over %u kernel variants, %llu overlaps, %u failures\n",
+		(unsigned long long)checks, unsigned(sizeof(variants) / sizeof(variants[0])), (unsigned long long)overlaps, failures);
+
+	return failures ? 1 : 0;
+}
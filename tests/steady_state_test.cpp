@@ -0,0 +1,159 @@
+// Plays games the way PlayState does, stepping the sim through a SimHistory
+// and drawing every frame with DrawWorld into a software renderer, and
+// fails if any frame after the warmup allocates from the heap. Always built
+// with allocation counting on, whatever the build type.
+//
+// usage: steady_state_test [--frames N]
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "alloc_tracker.h"
+#include "arena.h"
+#include "level_gen.h"
+#include "scene.h"
+#include "sim.h"
+#include "snapshot.h"
+
+namespace
+{
+	const size_t	frameArenaSize	= 16 << 20;
+	const uint32_t	warmupFrames	= 2;	// Let scratch buffers reach their working size
+	const float		tickDt			= 1.0f / 60.0f;
+
+	struct Scenario
+	{
+		const char*		name;
+		uint32_t		balls;
+		LevelPattern	pattern;
+		uint32_t		blockCount;		// 0 plays the built-in level
+		float			density;
+	};
+
+	const Scenario scenarios[] = {
+		{ "default",		1,		PatternBricks,	0,		1.0f },
+		{ "bricks-10k",		1,		PatternBricks,	10000,	1.0f },
+		{ "noise-10k",		16,		PatternNoise,	10000,	0.5f },
+		{ "balls-1k",		1000,	PatternGrid,	1000,	1.0f },
+	};
+
+	// Steers the paddle under the first ball, so games last.
+	SimInput Autopilot(const WorldState& world)
+	{
+		SimInput input;
+
+		if (world.balls.count)
+		{
+			const float offset = world.balls.x[0] - (world.paddle.x + world.paddle.w / 2.0f);
+			input.paddleAxis = int16_t(std::max(-32767.0f, std::min(offset * 2000.0f, 32767.0f)));
+		}
+
+		return input;
+	}
+
+	// Returns the number of frames after the warmup that allocated.
+	uint32_t RunScenario(const Scenario& scenario, const uint32_t frames, SDL_Renderer* renderer, FrameArena& arena)
+	{
+		std::vector<LevelBlock> blocks;
+
+		if (scenario.blockCount)
+		{
+			LevelGenParams params;
+			params.pattern		= scenario.pattern;
+			params.blockCount	= scenario.blockCount;
+			params.density		= scenario.density;
+
+			GenerateLevel(params, blocks);
+		}
+
+		BreakoutSim sim;
+		SimHistory	history(sim);
+
+		auto start = [&]()
+		{
+			if (blocks.size())
+				sim.Reset(blocks.data(), uint32_t(blocks.size()), scenario.balls);
+			else
+				sim.Reset(scenario.balls);
+
+			history.Clear();
+		};
+
+		start();
+
+		uint32_t warmupEnd		= warmupFrames;
+		uint32_t failedFrames	= 0;
+
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			const uint64_t allocationsBefore = AllocationCount();
+
+			arena.Reset();
+
+			// A new game may reallocate, so it gets its own warmup.
+			if (history.Step(Autopilot(sim.world), tickDt) != SimStatus::Running)
+			{
+				start();
+				warmupEnd = frame + 1 + warmupFrames;
+				continue;
+			}
+
+			DrawWorld(renderer, sim.world, 1.0f, tickDt, arena);
+			SDL_RenderPresent(renderer);
+
+			const uint64_t frameAllocations = AllocationCount() - allocationsBefore;
+
+			if (frame >= warmupEnd && frameAllocations && failedFrames++ < 5)
+				printf("  %s: frame %u allocated %llu times\n", scenario.name, frame, (unsigned long long)frameAllocations);
+		}
+
+		return failedFrames;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t frames = 2000;
+
+	for (int I = 1; I + 1 < argc; I += 2)
+	{
+		if (strcmp(argv[I], "--frames") == 0)
+			frames = uint32_t(std::max(warmupFrames + 1, uint32_t(atoi(argv[I + 1]))));
+	}
+
+#if !BREAKOUT_COUNT_ALLOCATIONS
+	printf("built without allocation counting\n");
+	return 1;
+#endif
+
+	SDL_Surface*	target		= SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA8888);
+	SDL_Renderer*	renderer	= target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+
+	if (!renderer)
+	{
+		printf("failed to create a software renderer: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	FrameArena arena(frameArenaSize);
+
+	uint32_t failures = 0;
+
+	for (const Scenario& scenario : scenarios)
+	{
+		const uint32_t failedFrames = RunScenario(scenario, frames, renderer, arena);
+
+		printf("%-12s %u frames, %u allocated after warmup\n", scenario.name, frames, failedFrames);
+		failures += failedFrames;
+	}
+
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+
+	return failures ? 1 : 0;
+}
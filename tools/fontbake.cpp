@@ -0,0 +1,59 @@
+// Rasterizes a TrueType font into the binary atlas the game loads at startup.
+// usage: fontbake <font.ttf> <font.bin>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "font_atlas.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		printf("usage: fontbake <font.ttf> <font.bin>\n");
+		return 1;
+	}
+
+	FILE* input = fopen(argv[1], "rb");
+	if (!input)
+	{
+		printf("failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	fseek(input, 0, SEEK_END);
+	std::vector<uint8_t> ttf(ftell(input));
+	fseek(input, 0, SEEK_SET);
+
+	const bool read = fread(ttf.data(), ttf.size(), 1, input) == 1;
+	fclose(input);
+
+	FontAtlas atlas;
+	if (!read || !BuildFontAtlas(ttf.data(), atlas))
+		return 1;
+
+	BakedFontHeader header;
+	memcpy(header.magic, "BKFN", 4);
+	header.version		= BakedFontVersion;
+	header.width		= atlas.width;
+	header.height		= atlas.height;
+	header.pixelHeight	= atlas.pixelHeight;
+	header.ascent		= atlas.ascent;
+	header.firstChar	= FontFirstChar;
+	header.charCount	= FontCharCount;
+
+	FILE* output = fopen(argv[2], "wb");
+	if (!output)
+	{
+		printf("failed to open %s\n", argv[2]);
+		return 1;
+	}
+
+	fwrite(&header, sizeof(header), 1, output);
+	fwrite(atlas.glyphs, sizeof(atlas.glyphs), 1, output);
+	fwrite(atlas.alpha.data(), 1, atlas.alpha.size(), output);
+	fclose(output);
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+// Compiles a text level source into the binary level file the game loads.
+// usage: levelc <level.txt> <level.lvl>
+// See assets/levels/default.txt for the source format.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "level.h"
+
+namespace
+{
+	struct BlockSettings
+	{
+		uint16_t	hp		= 1;
+		uint8_t		type	= BlockNormal;
+		uint32_t	color	= 0x8B7E74FF;
+	};
+
+	LevelBlock MakeBlock(const float x, const float y, const float w, const float h, const BlockSettings& settings)
+	{
+		return LevelBlock{ x, y, w, h, settings.hp, settings.type, 0, settings.color };
+	}
+
+	bool ParseLine(const char* line, BlockSettings& settings, std::vector<LevelBlock>& blocks)
+	{
+		char	keyword[16];
+		int		consumed = 0;
+
+		if (sscanf(line, " %15s%n", keyword, &consumed) != 1 || keyword[0] == '#')
+			return true;
+
+		const char* args = line + consumed;
+
+		if (strcmp(keyword, "block") == 0)
+		{
+			float x, y, w, h;
+			if (sscanf(args, "%f %f %f %f", &x, &y, &w, &h) != 4 || w <= 0 || h <= 0)
+				return false;
+
+			blocks.push_back(MakeBlock(x, y, w, h, settings));
+			return true;
+		}
+
+		if (strcmp(keyword, "row") == 0)
+		{
+			int		count;
+			float	x, y, stepX, w, h;
+			if (sscanf(args, "%d %f %f %f %f %f", &count, &x, &y, &stepX, &w, &h) != 6 || count <= 0 || w <= 0 || h <= 0)
+				return false;
+
+			for (int I = 0; I < count; I++)
+				blocks.push_back(MakeBlock(x + stepX * I, y, w, h, settings));
+
+			return true;
+		}
+
+		if (strcmp(keyword, "hp") == 0)
+		{
+			int hp;
+			if (sscanf(args, "%d", &hp) != 1 || hp < 1 || hp > 0xFFFF)
+				return false;
+
+			settings.hp = uint16_t(hp);
+			return true;
+		}
+
+		if (strcmp(keyword, "color") == 0)
+		{
+			char hex[16];
+			if (sscanf(args, "%15s", hex) != 1)
+				return false;
+
+			const size_t digits = strlen(hex);
+			if ((digits != 6 && digits != 8) || strspn(hex, "0123456789abcdefABCDEF") != digits)
+				return false;
+
+			const uint32_t value = uint32_t(strtoul(hex, nullptr, 16));
+			settings.color = digits == 6 ? (value << 8) | 0xFF : value;
+			return true;
+		}
+
+		if (strcmp(keyword, "type") == 0)
+		{
+			char name[16];
+			if (sscanf(args, "%15s", name) != 1)
+				return false;
+
+			if (strcmp(name, "normal") == 0)
+				settings.type = BlockNormal;
+			else if (strcmp(name, "multiball") == 0)
+				settings.type = BlockMultiBall;
+			else
+				return false;
+
+			return true;
+		}
+
+		return false;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		printf("usage: levelc <level.txt> <level.lvl>\n");
+		return 1;
+	}
+
+	FILE* input = fopen(argv[1], "r");
+	if (!input)
+	{
+		printf("failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	BlockSettings			settings;
+	std::vector<LevelBlock>	blocks;
+
+	char	line[256];
+	int		lineNumber = 0;
+
+	while (fgets(line, sizeof(line), input))
+	{
+		lineNumber++;
+
+		if (!ParseLine(line, settings, blocks))
+		{
+			printf("%s:%d: invalid line: %s", argv[1], lineNumber, line);
+			fclose(input);
+			return 1;
+		}
+	}
+
+	fclose(input);
+
+	LevelHeader header;
+	memcpy(header.magic, "BKLV", 4);
+	header.version		= LevelVersion;
+	header.blockCount	= uint32_t(blocks.size());
+	header.reserved		= 0;
+
+	FILE* output = fopen(argv[2], "wb");
+	if (!output)
+	{
+		printf("failed to open %s\n", argv[2]);
+		return 1;
+	}
+
+	fwrite(&header, sizeof(header), 1, output);
+	fwrite(blocks.data(), sizeof(LevelBlock), blocks.size(), output);
+	fclose(output);
+
+	return 0;
+}